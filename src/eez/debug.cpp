@@ -19,9 +19,22 @@
 #ifdef DEBUG
 
 #include <cstdio>
+#include <new>
 #include <stdarg.h>
 #include <string.h>
 
+#if defined(EEZ_PLATFORM_STM32)
+#include <cmsis_os.h>
+#include <eez/platform/stm32/dwt_delay.h>
+#endif
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdlib.h>
+#endif
+
 #include <eez/debug.h>
 #include <eez/memory.h>
 #include <eez/system.h>
@@ -288,8 +301,11 @@ void DebugDurationVariable::finish() {
 }
 
 void DebugDurationVariable::tick(uint32_t tickCount) {
-    uint32_t duration = tickCount - m_lastTickCount;
+    addDuration(tickCount - m_lastTickCount);
+    m_lastTickCount = tickCount;
+}
 
+void DebugDurationVariable::addDuration(uint32_t duration) {
     duration1sec.tick(duration);
     duration10sec.tick(duration);
 
@@ -300,8 +316,6 @@ void DebugDurationVariable::tick(uint32_t tickCount) {
     if (duration > m_maxTotal) {
         m_maxTotal = duration;
     }
-
-    m_lastTickCount = tickCount;
 }
 
 void DebugDurationVariable::tick1secPeriod() {
@@ -375,6 +389,241 @@ void DebugCounterVariable::dump(char *buffer) {
     strcatUInt32(buffer, m_totalCounter);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+static DebugProbe *g_firstProbe;
+static DebugProbe *g_lastProbe;
+
+alignas(DebugProbe) static uint8_t g_dynamicProbesStorage[DebugProbe::MAX_DYNAMIC_PROBES][sizeof(DebugProbe)];
+static DebugProbe *g_dynamicProbes[DebugProbe::MAX_DYNAMIC_PROBES];
+static volatile int g_numDynamicProbes;
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+static std::mutex g_probesMutex;
+
+static std::mutex g_traceMutex;
+static std::atomic<bool> g_isTraceStarted;
+static FILE *g_traceFile;
+static bool g_isFirstTraceEvent;
+static int g_numTraceThreads;
+static thread_local int t_traceThreadId;
+#endif
+
+static void lockProbes() {
+#if defined(EEZ_PLATFORM_STM32)
+    // static probes are constructed before the kernel is started, there is only one thread then
+    // and the critical section would leave the interrupts disabled until the scheduler starts
+    if (osKernelRunning()) {
+        taskENTER_CRITICAL();
+    }
+#else
+    g_probesMutex.lock();
+#endif
+}
+
+static void unlockProbes() {
+#if defined(EEZ_PLATFORM_STM32)
+    if (osKernelRunning()) {
+        taskEXIT_CRITICAL();
+    }
+#else
+    g_probesMutex.unlock();
+#endif
+}
+
+// DWT cycle count on STM32, microseconds since the first call on the simulator
+static uint32_t getProbeTimestamp() {
+#if defined(EEZ_PLATFORM_STM32)
+    return *DWT_CYCCNT;
+#else
+    static const std::chrono::steady_clock::time_point g_startTime = std::chrono::steady_clock::now();
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - g_startTime).count();
+#endif
+}
+
+static uint32_t getProbeDuration(uint32_t startTimestamp) {
+#if defined(EEZ_PLATFORM_STM32)
+    // cycle counter wraps around every ~20 seconds
+    if (g_cyclesPerMicrosecond == 0) {
+        return 0;
+    }
+    return (*DWT_CYCCNT - startTimestamp) / g_cyclesPerMicrosecond;
+#else
+    return getProbeTimestamp() - startTimestamp;
+#endif
+}
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+static void traceEvent(const char *name, uint32_t startTime, uint32_t duration) {
+    std::lock_guard<std::mutex> lock(g_traceMutex);
+
+    if (!g_traceFile) {
+        return;
+    }
+
+    if (t_traceThreadId == 0) {
+        t_traceThreadId = ++g_numTraceThreads;
+    }
+
+    fprintf(g_traceFile, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%u,\"dur\":%u}",
+        g_isFirstTraceEvent ? "" : ",\n", name, t_traceThreadId, (unsigned)startTime, (unsigned)duration);
+
+    g_isFirstTraceEvent = false;
+}
+#endif
+
+DebugProbe::DebugProbe(const char *name)
+    : DebugProbe(name, true) {
+}
+
+DebugProbe::DebugProbe(const char *name, bool lock)
+    : DebugDurationVariable(name), m_count(0), m_total(0), m_next(nullptr) {
+    memset(m_histogram, 0, sizeof(m_histogram));
+
+    // getDynamic already holds the lock
+    if (lock) {
+        lockProbes();
+    }
+
+    if (g_lastProbe) {
+        g_lastProbe->m_next = this;
+    } else {
+        g_firstProbe = this;
+    }
+    g_lastProbe = this;
+
+    if (lock) {
+        unlockProbes();
+    }
+}
+
+void DebugProbe::start() {
+    m_startTime = getProbeTimestamp();
+}
+
+void DebugProbe::finish() {
+    uint32_t duration = getProbeDuration(m_startTime);
+
+    addDuration(duration);
+
+    m_count++;
+    m_total += duration;
+
+    int bucketIndex = 0;
+    for (uint32_t i = duration; i > 0 && bucketIndex < DEBUG_PROBE_NUM_HISTOGRAM_BUCKETS - 1; i >>= 1) {
+        bucketIndex++;
+    }
+    m_histogram[bucketIndex]++;
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+    if (g_isTraceStarted) {
+        traceEvent(name(), m_startTime, duration);
+    }
+#endif
+}
+
+void DebugProbe::reset() {
+    m_minTotal = 4294967295UL;
+    m_maxTotal = 0;
+    m_count = 0;
+    m_total = 0;
+    memset(m_histogram, 0, sizeof(m_histogram));
+}
+
+DebugProbe *DebugProbe::getFirst() {
+    return g_firstProbe;
+}
+
+DebugProbe *DebugProbe::find(const char *name) {
+    for (DebugProbe *probe = g_firstProbe; probe; probe = probe->m_next) {
+        if (strcmp(probe->name(), name) == 0) {
+            return probe;
+        }
+    }
+    return nullptr;
+}
+
+DebugProbe *DebugProbe::getDynamic(const char *name) {
+    // probes are only added, so the lookup doesn't need the lock
+    int numDynamicProbes = g_numDynamicProbes;
+    for (int i = 0; i < numDynamicProbes; i++) {
+        if (g_dynamicProbes[i]->name() == name) {
+            return g_dynamicProbes[i];
+        }
+    }
+
+    DebugProbe *probe = nullptr;
+
+    lockProbes();
+
+    // check again, probe could be created by some other thread in the meantime
+    int i;
+    for (i = 0; i < g_numDynamicProbes; i++) {
+        if (g_dynamicProbes[i]->name() == name) {
+            probe = g_dynamicProbes[i];
+            break;
+        }
+    }
+
+    if (!probe && i < MAX_DYNAMIC_PROBES) {
+        probe = new (g_dynamicProbesStorage[i]) DebugProbe(name, false);
+        g_dynamicProbes[i] = probe;
+        g_numDynamicProbes = i + 1;
+    }
+
+    unlockProbes();
+
+    return probe;
+}
+
+void resetProbes() {
+    for (DebugProbe *probe = g_firstProbe; probe; probe = probe->getNext()) {
+        probe->reset();
+    }
+}
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+
+bool startTrace(const char *filePath) {
+    stopTrace();
+
+    FILE *file = fopen(filePath, "w");
+    if (!file) {
+        return false;
+    }
+
+    static bool g_isAtExitRegistered;
+    if (!g_isAtExitRegistered) {
+        // file is not valid JSON without the closing bracket
+        atexit(stopTrace);
+        g_isAtExitRegistered = true;
+    }
+
+    std::lock_guard<std::mutex> lock(g_traceMutex);
+    fputs("[\n", file);
+    g_traceFile = file;
+    g_isFirstTraceEvent = true;
+    g_isTraceStarted = true;
+
+    return true;
+}
+
+void stopTrace() {
+    std::lock_guard<std::mutex> lock(g_traceMutex);
+    if (g_traceFile) {
+        g_isTraceStarted = false;
+        fputs("\n]\n", g_traceFile);
+        fclose(g_traceFile);
+        g_traceFile = nullptr;
+    }
+}
+
+bool isTraceStarted() {
+    return g_isTraceStarted;
+}
+
+#endif
+
 } // namespace debug
 } // namespace eez
 
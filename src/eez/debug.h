@@ -45,10 +45,18 @@ void onEncoder(int couter);
 
 #define DebugTrace(...) ::eez::debug::Trace(__VA_ARGS__)
 
+#define DebugProbeDefine(probe, name) static ::eez::debug::DebugProbe probe(name)
+#define DebugProbeStart(probe) (probe).start()
+#define DebugProbeFinish(probe) (probe).finish()
+
 #else // NO DEBUG
 
 #define DebugTrace(...) 0
 
+#define DebugProbeDefine(probe, name) typedef int probe##_unused
+#define DebugProbeStart(probe) 0
+#define DebugProbeFinish(probe) 0
+
 #endif
 
 #ifdef DEBUG
@@ -121,7 +129,9 @@ class DebugDurationVariable : public DebugVariable {
     void tick10secPeriod();
     void dump(char *buffer);
 
-  private:
+  protected:
+    void addDuration(uint32_t duration);
+
     uint32_t m_lastTickCount;
 
     DebugDurationForPeriod duration1sec;
@@ -131,6 +141,77 @@ class DebugDurationVariable : public DebugVariable {
     uint32_t m_maxTotal;
 };
 
+static const int DEBUG_PROBE_NUM_HISTOGRAM_BUCKETS = 24;
+
+// Duration variable, in microseconds, with the log2 histogram of all the measured durations.
+// Probes are registered by name, so they can be found and queried over SCPI and, on the
+// simulator, every measurement is also written to the trace file (see startTrace).
+// Time is measured with DWT cycle counter on STM32 and with the real (not virtual) clock on
+// the simulator. One probe should not be started from more than one thread at the same time.
+class DebugProbe : public DebugDurationVariable {
+  public:
+    DebugProbe(const char *name);
+
+    void start();
+    void finish();
+
+    void reset();
+
+    uint32_t getCount() {
+        return m_count;
+    }
+    uint32_t getMin() {
+        return m_count > 0 ? m_minTotal : 0;
+    }
+    uint32_t getMax() {
+        return m_maxTotal;
+    }
+    uint32_t getAverage() {
+        return m_count > 0 ? (uint32_t)(m_total / m_count) : 0;
+    }
+
+    // Bucket 0 counts durations below 1 us, bucket i durations from 2^(i-1) to 2^i us
+    // and the last bucket all the longer durations.
+    uint32_t getHistogramBucket(int bucketIndex) {
+        return m_histogram[bucketIndex];
+    }
+
+    DebugProbe *getNext() {
+        return m_next;
+    }
+
+    static DebugProbe *getFirst();
+    static DebugProbe *find(const char *name);
+
+    // Returns probe for the name, which is created on the first call, or nullptr if all the
+    // MAX_DYNAMIC_PROBES are already used. Name is not copied and it is compared by pointer,
+    // so it should be some constant string, like SCPI command pattern.
+    static DebugProbe *getDynamic(const char *name);
+
+    static const int MAX_DYNAMIC_PROBES = 64;
+
+  private:
+    DebugProbe(const char *name, bool lock);
+
+    uint32_t m_startTime;
+
+    uint32_t m_count;
+    uint64_t m_total;
+    uint32_t m_histogram[DEBUG_PROBE_NUM_HISTOGRAM_BUCKETS];
+
+    DebugProbe *m_next;
+};
+
+void resetProbes();
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+// Writes Chrome/Perfetto trace file (JSON array format, open it in chrome://tracing or
+// ui.perfetto.dev) with one complete event for each probe measurement, until stopTrace.
+bool startTrace(const char *filePath);
+void stopTrace();
+bool isTraceStarted();
+#endif
+
 class DebugCounterForPeriod {
   public:
     DebugCounterForPeriod();
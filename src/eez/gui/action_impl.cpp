@@ -305,6 +305,11 @@ void action_show_ch_settings() {
     showPage(PAGE_ID_CH_SETTINGS);
 }
 
+void action_ch_statistics_reset() {
+    selectChannel();
+    g_channel->resetStatistics();
+}
+
 void action_show_ch_settings_prot_clear() {
     selectChannel();
     pushPage(PAGE_ID_CH_SETTINGS_PROT_CLEAR);
@@ -125,13 +125,21 @@ void FLOAT_value_to_text(const Value &value, char *text, int count) {
                 unit = UNIT_MILLI_SECOND;
                 floatValue *= 1000.0f;
             }
+        } else if (unit == UNIT_AMPER_HOUR) {
+            if (fabs(floatValue) < 1) {
+                unit = UNIT_MILLI_AMPER_HOUR;
+                floatValue *= 1000.0f;
+            }
+        } else if (unit == UNIT_WATT_HOUR) {
+            if (fabs(floatValue) < 1) {
+                unit = UNIT_MILLI_WATT_HOUR;
+                floatValue *= 1000.0f;
+            }
         }
     }
 
     if (!isNaN(floatValue)) {
-        strcatFloat(text, floatValue);
-        removeTrailingZerosFromFloat(text);
-        strcat(text, getUnitName(unit));
+        formatFloat(text, floatValue, getUnitName(unit));
     } else {
         text[0] = 0;
     }
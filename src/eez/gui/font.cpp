@@ -18,6 +18,8 @@
 
 #include <eez/gui/font.h>
 
+#include <eez/memory.h>
+
 namespace eez {
 namespace gui {
 namespace font {
@@ -37,6 +39,34 @@ offset
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Glyph headers are decoded once per font, so getGlyph() for every drawn or measured character
+// is a table lookup. Glyph pixels are already 8-bit alpha in the decompressed assets, so they
+// are not copied, cached glyph only keeps their offset.
+
+struct CachedGlyph {
+    uint32_t offset; // from the start of font data, 0 for missing or empty glyph
+    int8_t dx;
+    int8_t x;
+    int8_t y;
+    uint8_t width;
+    uint8_t height;
+};
+
+struct FontGlyphCache {
+    const uint8_t *fontData;
+    uint8_t encodingStart;
+    uint8_t encodingEnd;
+    CachedGlyph glyphs[256];
+};
+
+static const int NUM_FONT_GLYPH_CACHES = GLYPH_CACHE_BUFFER_SIZE / sizeof(FontGlyphCache);
+static FontGlyphCache * const g_fontGlyphCaches = (FontGlyphCache *)GLYPH_CACHE_BUFFER;
+static int g_numFontGlyphCaches;
+static int g_nextFontGlyphCacheToReplace;
+static FontGlyphCache *g_lastFontGlyphCache;
+
+////////////////////////////////////////////////////////////////////////////////
+
 Font::Font() : fontData(0) {
 }
 
@@ -105,11 +135,73 @@ void Font::fillGlyphParameters(Glyph &glyph) {
     glyph.y = (int8_t)glyph.data[4];
 }
 
+FontGlyphCache *Font::getGlyphCache() {
+    // the same font is usually asked for all the characters of a string
+    if (g_lastFontGlyphCache && g_lastFontGlyphCache->fontData == fontData) {
+        return g_lastFontGlyphCache;
+    }
+
+    for (int i = 0; i < g_numFontGlyphCaches; i++) {
+        if (g_fontGlyphCaches[i].fontData == fontData) {
+            g_lastFontGlyphCache = &g_fontGlyphCaches[i];
+            return g_lastFontGlyphCache;
+        }
+    }
+
+    FontGlyphCache *cache;
+    if (g_numFontGlyphCaches < NUM_FONT_GLYPH_CACHES) {
+        cache = &g_fontGlyphCaches[g_numFontGlyphCaches++];
+    } else {
+        cache = &g_fontGlyphCaches[g_nextFontGlyphCacheToReplace];
+        g_nextFontGlyphCacheToReplace = (g_nextFontGlyphCacheToReplace + 1) % NUM_FONT_GLYPH_CACHES;
+    }
+
+    cache->fontData = fontData;
+    cache->encodingStart = getEncodingStart();
+    cache->encodingEnd = getEncodingEnd();
+
+    for (int encoding = cache->encodingStart; encoding <= cache->encodingEnd; encoding++) {
+        CachedGlyph &cachedGlyph = cache->glyphs[encoding - cache->encodingStart];
+
+        Glyph glyph;
+        glyph.data = findGlyphData((uint8_t)encoding);
+        if (glyph.data) {
+            fillGlyphParameters(glyph);
+            cachedGlyph.offset = glyph.data - fontData;
+            cachedGlyph.dx = glyph.dx;
+            cachedGlyph.x = glyph.x;
+            cachedGlyph.y = glyph.y;
+            cachedGlyph.width = glyph.width;
+            cachedGlyph.height = glyph.height;
+        } else {
+            cachedGlyph.offset = 0;
+        }
+    }
+
+    g_lastFontGlyphCache = cache;
+    return cache;
+}
+
 void Font::getGlyph(uint8_t requested_encoding, Glyph &glyph) {
-    glyph.data = findGlyphData(requested_encoding);
-    if (glyph.data) {
-        fillGlyphParameters(glyph);
+    FontGlyphCache *cache = getGlyphCache();
+
+    if (requested_encoding < cache->encodingStart || requested_encoding > cache->encodingEnd) {
+        glyph.data = nullptr;
+        return;
+    }
+
+    CachedGlyph &cachedGlyph = cache->glyphs[requested_encoding - cache->encodingStart];
+    if (!cachedGlyph.offset) {
+        glyph.data = nullptr;
+        return;
     }
+
+    glyph.data = fontData + cachedGlyph.offset;
+    glyph.dx = cachedGlyph.dx;
+    glyph.x = cachedGlyph.x;
+    glyph.y = cachedGlyph.y;
+    glyph.width = cachedGlyph.width;
+    glyph.height = cachedGlyph.height;
 }
 
 } // namespace font
@@ -26,6 +26,8 @@ namespace font {
 
 static const int GLYPH_HEADER_SIZE = 5;
 
+struct FontGlyphCache;
+
 struct Glyph {
     const uint8_t *data;
 
@@ -58,6 +60,8 @@ struct Font {
 
     const uint8_t *findGlyphData(uint8_t requested_encoding);
     void fillGlyphParameters(Glyph &glyph);
+
+    FontGlyphCache *getGlyphCache();
 };
 
 } // namespace font
@@ -28,6 +28,7 @@
 #include <eez/gui/event.h>
 #include <eez/gui/touch.h>
 #include <eez/gui/update.h>
+#include <eez/debug.h>
 #include <eez/sound.h>
 #include <eez/system.h>
 #include <eez/util.h>
@@ -81,6 +82,8 @@ void oneIter();
 
 static bool g_assetsInitialized = false;
 
+DebugProbeDefine(g_updateScreenProbe, "gui:updateScreen");
+
 void mainLoop(const void *) {
 	if (!g_assetsInitialized) {
 		g_assetsInitialized = true;
@@ -116,6 +119,12 @@ void oneIter() {
     eventHandling();
     stateManagmentHook();
 
+#if defined(EEZ_PLATFORM_SIMULATOR)
+    if (!mcu::display::isDrawingEnabled()) {
+        return;
+    }
+#endif
+
 #if OPTION_SDRAM
     bool wasOn = mcu::display::isOn();
     if (wasOn) {
@@ -129,7 +138,9 @@ void oneIter() {
             mcu::display::beginBuffersDrawing();
         }
 #endif
+        DebugProbeStart(g_updateScreenProbe);
         updateScreen();
+        DebugProbeFinish(g_updateScreenProbe);
     }
 
 #if OPTION_SDRAM
@@ -47,6 +47,7 @@ struct YTGraphDrawHelper {
 
     uint16_t color16;
     uint16_t dataColor16[2];
+    uint16_t envelopeColor16[2];
 
     uint32_t numPositions;
     uint32_t position;
@@ -55,6 +56,8 @@ struct YTGraphDrawHelper {
 
     int yPrev[2];
     int y[2];
+    int yEnvelopeTop[2];
+    int yEnvelopeBottom[2];
 
     Value::YtDataGetValueFunctionPointer ytDataGetValue;
 
@@ -73,6 +76,13 @@ struct YTGraphDrawHelper {
         ytDataGetValue = data::ytDataGetGetValueFunc(widgetCursor.cursor, widget->data);
     }
 
+    void initEnvelopeColors() {
+        // envelope is drawn in the data color blended 50% with the graph background
+        for (int valueIndex = 0; valueIndex < 2; valueIndex++) {
+            envelopeColor16[valueIndex] = ((dataColor16[valueIndex] & 0xF7DE) >> 1) + ((color16 & 0xF7DE) >> 1);
+        }
+    }
+
     int getYValue(int valueIndex, uint32_t position) {
         if (position >= numPositions) {
             return INT_MIN;
@@ -93,6 +103,44 @@ struct YTGraphDrawHelper {
         return widget->h - 1 - y;
     }
 
+    void getYEnvelope(int valueIndex, uint32_t position) {
+        yEnvelopeTop[valueIndex] = INT_MIN;
+        yEnvelopeBottom[valueIndex] = INT_MIN;
+
+        if (position >= numPositions) {
+            return;
+        }
+
+        float fMax = NAN;
+        float fMin = ytDataGetValue(position, valueIndex, &fMax);
+
+        if (isNaN(fMin) || isNaN(fMax)) {
+            return;
+        }
+
+        // unlike the mean value, envelope is clipped to the graph area so that spikes outside of it are still visible
+        int yTop = widget->h - 1 - (int)round((widget->h - 1) * (fMax - min[valueIndex]) / (max[valueIndex] - min[valueIndex]));
+        int yBottom = widget->h - 1 - (int)round((widget->h - 1) * (fMin - min[valueIndex]) / (max[valueIndex] - min[valueIndex]));
+
+        if (yBottom < 0 || yTop >= widget->h) {
+            return;
+        }
+
+        yEnvelopeTop[valueIndex] = MAX(yTop, 0);
+        yEnvelopeBottom[valueIndex] = MIN(yBottom, widget->h - 1);
+    }
+
+    void drawEnvelope(int valueIndex) {
+        getYEnvelope(valueIndex, position);
+
+        if (yEnvelopeTop[valueIndex] == INT_MIN || yEnvelopeTop[valueIndex] == yEnvelopeBottom[valueIndex]) {
+            return;
+        }
+
+        display::setColor16(envelopeColor16[valueIndex]);
+        display::drawVLine(x, widgetCursor.y + yEnvelopeTop[valueIndex], yEnvelopeBottom[valueIndex] - yEnvelopeTop[valueIndex]);
+    }
+
     void drawValue(int valueIndex) {
         if (y[valueIndex] == INT_MIN) {
             return;
@@ -112,6 +160,9 @@ struct YTGraphDrawHelper {
     }
 
     void drawStep() {
+        drawEnvelope(0);
+        drawEnvelope(1);
+
         if (y[0] != INT_MIN && y[1] != INT_MIN && abs(yPrev[0] - y[0]) <= 1 && abs(yPrev[1] - y[1]) <= 1 && y[0] == y[1]) {
             display::setColor16(position % 2 ? dataColor16[1] : dataColor16[0]);
             display::drawPixel(x, widgetCursor.y + y[0]);
@@ -124,6 +175,8 @@ struct YTGraphDrawHelper {
     void drawScanLine(uint32_t startPosition, uint32_t endPosition, uint16_t graphWidth) {
         numPositions = endPosition;
 
+        initEnvelopeColors();
+
         int x1 = widgetCursor.x + startPosition % graphWidth;
         int x2 = widgetCursor.x + (endPosition - 1) % graphWidth;
         display::setColor16(color16);
@@ -153,6 +206,8 @@ struct YTGraphDrawHelper {
             numPointsToDraw = graphWidth;
         }
 
+        initEnvelopeColors();
+
         if (numPointsToDraw < graphWidth) {
             display::bitBlt(
                 widgetCursor.x + numPointsToDraw,
@@ -161,6 +161,7 @@ class SdFat {
     bool rmdir(const char *path);
 
     bool getInfo(uint64_t &usedSpace, uint64_t &freeSpace);
+    uint32_t getClusterSize();
 };
 
 char *getConfFilePath(const char *file_name);
@@ -459,4 +459,17 @@ bool SdFat::getInfo(uint64_t &usedSpace, uint64_t &freeSpace) {
 #endif
 }
 
+uint32_t SdFat::getClusterSize() {
+#ifdef EEZ_PLATFORM_SIMULATOR_WIN32
+    DWORD sectorsPerCluster, bytesPerSector, numberOfFreeClusters, totalNumberOfClusters;
+    GetDiskFreeSpaceA(getRealPath("").c_str(), &sectorsPerCluster, &bytesPerSector,
+                      &numberOfFreeClusters, &totalNumberOfClusters);
+    return bytesPerSector * sectorsPerCluster;
+#else
+    struct statvfs buf;
+    statvfs(getRealPath("").c_str(), &buf);
+    return buf.f_bsize;
+#endif
+}
+
 } // namespace eez
\ No newline at end of file
@@ -291,4 +291,8 @@ bool SdFat::getInfo(uint64_t &usedSpace, uint64_t &freeSpace) {
     return true;
 }
 
+uint32_t SdFat::getClusterSize() {
+    return SDFatFS.csize * 512;
+}
+
 } // namespace eez
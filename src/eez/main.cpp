@@ -56,6 +56,10 @@
 #include <eez/modules/psu/sd_card.h>
 #endif
 
+#if defined(EEZ_PLATFORM_SIMULATOR)
+#include <eez/platform/simulator/headless.h>
+#endif
+
 #if defined(EEZ_PLATFORM_STM32)
 extern "C" void SystemClock_Config(void);
 
@@ -165,7 +169,8 @@ int main(int argc, char **argv) {
 
     SystemClock_Config();
 
-    // DWT_Delay_Init();
+    // cycle counter is used by the PSU task scheduler and the debug probes
+    DWT_Delay_Init();
 
     MX_GPIO_Init();
     MX_DMA_Init();
@@ -194,6 +199,9 @@ int main(int argc, char **argv) {
     mount_file_system();
     emscripten_set_main_loop(main_loop, 4, true);
 #else
+#if defined(EEZ_PLATFORM_SIMULATOR)
+    eez::platform::simulator::parseCommandLine(argc, argv);
+#endif
     eez::boot();
 #endif
 
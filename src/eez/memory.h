@@ -42,7 +42,11 @@ static const uint32_t DECOMPRESSED_ASSETS_SIZE = 4 * 1024 * 1024;
 static uint8_t * const DLOG_RECORD_BUFFER = DECOMPRESSED_ASSETS_START_ADDRESS + DECOMPRESSED_ASSETS_SIZE;
 static const uint32_t DLOG_RECORD_BUFFER_SIZE = 128 * 1024;
 
-static uint8_t * const FILE_VIEW_BUFFER = DLOG_RECORD_BUFFER + DLOG_RECORD_BUFFER_SIZE;
+// used for VERSION3 (compressed) dlog files: block index, encoding buffers and LZ4 state
+static uint8_t * const DLOG_COMPRESS_BUFFER = DLOG_RECORD_BUFFER + DLOG_RECORD_BUFFER_SIZE;
+static const uint32_t DLOG_COMPRESS_BUFFER_SIZE = 80 * 1024;
+
+static uint8_t * const FILE_VIEW_BUFFER = DLOG_COMPRESS_BUFFER + DLOG_COMPRESS_BUFFER_SIZE;
 static const uint32_t FILE_VIEW_BUFFER_SIZE = (3 * 512 - 128) * 1024;
 
 static uint8_t * const MP_BUFFER = FILE_VIEW_BUFFER + FILE_VIEW_BUFFER_SIZE;
@@ -60,7 +64,34 @@ static const uint32_t VRAM_SCREENSHOOT_JPEG_OUT_BUFFER_SIZE = 256 * 1024;
 static uint8_t * const DEBUG_TRACE_LOG = VRAM_SCREENSHOOT_JPEG_OUT_BUFFER + VRAM_SCREENSHOOT_JPEG_OUT_BUFFER_SIZE;
 static const uint32_t DEBUG_TRACE_LOG_SIZE = 32 * 1024;
 
-static uint8_t * const SCREENSHOOT_BUFFER_START_ADDRESS = DEBUG_TRACE_LOG + DEBUG_TRACE_LOG_SIZE;
+static uint8_t * const SCPI_COMMAND_INDEX_MEMORY = DEBUG_TRACE_LOG + DEBUG_TRACE_LOG_SIZE;
+static const uint32_t SCPI_COMMAND_INDEX_MEMORY_SIZE = 64 * 1024;
+
+// rows copied from DLOG_RECORD_BUFFER for the SENSe:DLOG:DATA? query
+static uint8_t * const DLOG_STREAM_BUFFER = SCPI_COMMAND_INDEX_MEMORY + SCPI_COMMAND_INDEX_MEMORY_SIZE;
+static const uint32_t DLOG_STREAM_BUFFER_SIZE = 16 * 1024;
+
+// window of points for each channel executing streamed list
+static uint8_t * const LIST_STREAM_BUFFER = DLOG_STREAM_BUFFER + DLOG_STREAM_BUFFER_SIZE;
+static const uint32_t LIST_STREAM_BUFFER_SIZE = 72 * 1024;
+
+// min, max and mean of U_MON, I_MON and power for each YT graph history slot of each channel
+static uint8_t * const CHANNEL_HISTORY_BUFFER = LIST_STREAM_BUFFER + LIST_STREAM_BUFFER_SIZE;
+static const uint32_t CHANNEL_HISTORY_BUFFER_SIZE = 108 * 1024;
+
+// decoded glyph headers of the fonts in use
+static uint8_t * const GLYPH_CACHE_BUFFER = CHANNEL_HISTORY_BUFFER + CHANNEL_HISTORY_BUFFER_SIZE;
+static const uint32_t GLYPH_CACHE_BUFFER_SIZE = 64 * 1024;
+
+// rows and write buffers used while the dlog file min/max pyramid is built
+static uint8_t * const DLOG_PYRAMID_BUFFER = GLYPH_CACHE_BUFFER + GLYPH_CACHE_BUFFER_SIZE;
+static const uint32_t DLOG_PYRAMID_BUFFER_SIZE = 64 * 1024;
+
+// used for viewing VERSION3 (compressed) dlog files: block index and decoding buffers
+static uint8_t * const DLOG_DECODE_BUFFER = DLOG_PYRAMID_BUFFER + DLOG_PYRAMID_BUFFER_SIZE;
+static const uint32_t DLOG_DECODE_BUFFER_SIZE = 80 * 1024;
+
+static uint8_t * const SCREENSHOOT_BUFFER_START_ADDRESS = DLOG_DECODE_BUFFER + DLOG_DECODE_BUFFER_SIZE;
 static const uint32_t SCREENSHOOT_BUFFER_SIZE = 480 * 272 * 3;
 
 #if defined(EEZ_PLATFORM_STM32)
@@ -91,4 +122,12 @@ static uint8_t * const VRAM_AUX_BUFFER6_START_ADDRESS = VRAM_AUX_BUFFER5_START_A
 static uint8_t * const VRAM_AUX_BUFFER7_START_ADDRESS = VRAM_AUX_BUFFER6_START_ADDRESS + VRAM_BUFFER_SIZE;
 static uint8_t * const VRAM_AUX_BUFFER8_START_ADDRESS = VRAM_AUX_BUFFER7_START_ADDRESS + VRAM_BUFFER_SIZE;
 
+#if defined(EEZ_PLATFORM_SIMULATOR)
+// copy of DLOG_RECORD_BUFFER kept while the dlog benchmark runs
+static uint8_t * const DLOG_BENCHMARK_BUFFER = VRAM_AUX_BUFFER8_START_ADDRESS + VRAM_BUFFER_SIZE;
+static const uint32_t DLOG_BENCHMARK_BUFFER_SIZE = DLOG_RECORD_BUFFER_SIZE;
+
+static uint8_t * const MEMORY_END = DLOG_BENCHMARK_BUFFER + DLOG_BENCHMARK_BUFFER_SIZE;
+#else
 static uint8_t * const MEMORY_END = VRAM_AUX_BUFFER8_START_ADDRESS + VRAM_BUFFER_SIZE;
+#endif
@@ -18,6 +18,8 @@
 
 #if OPTION_DISPLAY
 
+#include <string.h>
+
 #include <eez/modules/mcu/display.h>
 
 #include <eez/util.h>
@@ -259,9 +261,65 @@ int8_t measureGlyph(uint8_t encoding, gui::font::Font &font) {
     return glyph.dx;
 }
 
+// Widths of the recently measured strings. Widgets measure the same, mostly short, texts
+// (e.g. right aligned values) on every redraw.
+static const int STRING_WIDTH_CACHE_SIZE = 64; // must be power of 2
+static const int STRING_WIDTH_CACHE_MAX_TEXT_LENGTH = 24;
+
+struct StringWidthCacheEntry {
+    const uint8_t *fontData;
+    int16_t maxWidth;
+    int16_t width;
+    uint8_t textLength; // 0 if entry is not used
+    char text[STRING_WIDTH_CACHE_MAX_TEXT_LENGTH];
+};
+
+static StringWidthCacheEntry g_stringWidthCache[STRING_WIDTH_CACHE_SIZE];
+
+static int measureStrUncached(const char *text, int textLength, int max_width);
+
 int measureStr(const char *text, int textLength, gui::font::Font &font, int max_width) {
     g_font = font;
 
+    // FNV-1a of the text, font and max. width
+    uint32_t hash = 2166136261u;
+    int length;
+    for (length = 0; (textLength == -1 || length < textLength) && text[length]; length++) {
+        if (length == STRING_WIDTH_CACHE_MAX_TEXT_LENGTH) {
+            return measureStrUncached(text, textLength, max_width);
+        }
+        hash = (hash ^ (uint8_t)text[length]) * 16777619u;
+    }
+
+    if (length == 0) {
+        return 0;
+    }
+
+    hash = (hash ^ (uint32_t)(uintptr_t)font.fontData) * 16777619u;
+    hash = (hash ^ (uint32_t)max_width) * 16777619u;
+
+    StringWidthCacheEntry &entry = g_stringWidthCache[hash & (STRING_WIDTH_CACHE_SIZE - 1)];
+    if (
+        entry.textLength == length &&
+        entry.fontData == font.fontData &&
+        entry.maxWidth == max_width &&
+        memcmp(entry.text, text, length) == 0
+    ) {
+        return entry.width;
+    }
+
+    int width = measureStrUncached(text, length, max_width);
+
+    entry.fontData = font.fontData;
+    entry.maxWidth = (int16_t)max_width;
+    entry.width = (int16_t)width;
+    entry.textLength = (uint8_t)length;
+    memcpy(entry.text, text, length);
+
+    return width;
+}
+
+static int measureStrUncached(const char *text, int textLength, int max_width) {
     int width = 0;
 
     if (textLength == -1) {
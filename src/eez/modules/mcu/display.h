@@ -30,6 +30,14 @@ namespace display {
 void sync();
 void finishAnimation();
 
+#if defined(EEZ_PLATFORM_SIMULATOR)
+// false when headless simulator doesn't need the GUI drawn in this frame
+bool isDrawingEnabled();
+
+// Measures Mpixels/s of the fill, blit, blend and text (glyph blending) kernels.
+bool benchmark(int numFrames, float &fillMpixelsPerSecond, float &blitMpixelsPerSecond, float &blendMpixelsPerSecond, float &textMpixelsPerSecond);
+#endif
+
 void turnOn();
 void turnOff();
 bool isOn();
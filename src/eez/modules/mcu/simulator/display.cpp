@@ -23,11 +23,23 @@
 #include <math.h>
 #include <memory.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <string>
 #include <utility>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLEND_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BLEND_NEON
+#include <arm_neon.h>
+#endif
+
+#if !defined(EEZ_PLATFORM_SIMULATOR_HEADLESS)
 #include <SDL.h>
 #include <SDL_image.h>
+#endif
 
 #include <cmsis_os.h>
 #include <eez/modules/psu/gui/psu.h>
@@ -39,13 +51,13 @@
 #include <eez/gui/font.h>
 #include <eez/gui/widget.h>
 #include <eez/platform/simulator/front_panel.h>
+#include <eez/platform/simulator/headless.h>
 #include <eez/system.h>
 #include <eez/util.h>
 
-#include "texture.h"
-
 using namespace eez::gui;
 using namespace eez::psu::gui;
+using eez::platform::simulator::g_headless;
 
 namespace eez {
 namespace mcu {
@@ -58,40 +70,235 @@ static const char *ICON = "eez.png";
 
 static bool g_isOn;
 
+#if !defined(EEZ_PLATFORM_SIMULATOR_HEADLESS)
 static SDL_Window *g_mainWindow;
 static SDL_Renderer *g_renderer;
+// long-lived streaming texture, only the dirty regions of the painted buffer are uploaded to it
+static SDL_Texture *g_texture;
+#endif
 
 static uint32_t *g_buffer;
 static uint32_t *g_lastBuffer;
 
-static bool g_takeScreenshot;
+static volatile bool g_takeScreenshot;
 static int g_screenshotY;
 
+// in headless mode, set when GUI should be drawn in the current frame for the requested screenshot
+static bool g_screenshotFrameDrawn;
+
+struct DirtyRect {
+    int x1;
+    int y1;
+    int x2;
+    int y2;
+};
+
+static const int MAX_DIRTY_RECTS = 32;
+
+struct DirtyRegion {
+    DirtyRect rects[MAX_DIRTY_RECTS];
+    int numRects;
+};
+
+// Rectangles painted into the VRAM buffer in the current and in the previous frame.
+// Buffers are swapped after each frame, so the buffer about to be shown differs from
+// the texture (which holds the previous buffer) only inside the union of both regions.
+static DirtyRegion g_dirtyRegions[2];
+static DirtyRegion *g_dirtyRegion = &g_dirtyRegions[0];
+static DirtyRegion *g_previousDirtyRegion = &g_dirtyRegions[1];
+
+// set when the texture content is unknown and whole buffer must be uploaded
+static bool g_fullUpload = true;
+
 ////////////////////////////////////////////////////////////////////////////////
 
-static uint32_t blendColor(uint32_t fgColor, uint32_t bgColor) {
-    uint8_t *fg = (uint8_t *)&fgColor;
-    uint8_t *bg = (uint8_t *)&bgColor;
+static inline uint32_t div255(uint32_t x) {
+    // exact x / 255 for x <= 65535
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
+// Integer version of the "over" operator for BGRA pixels, alpha of fgColor is used as is.
+// Same result as the floating point formula, bit exact when background is opaque (the common case).
+static inline uint32_t blendColor(uint32_t fgColor, uint32_t bgColor) {
+    uint32_t fa = fgColor >> 24;
+    uint32_t ba = bgColor >> 24;
+
+    if (ba == 255) {
+        uint32_t ia = 255 - fa;
+        uint32_t b = div255((fgColor & 0xFF) * fa + (bgColor & 0xFF) * ia);
+        uint32_t g = div255(((fgColor >> 8) & 0xFF) * fa + ((bgColor >> 8) & 0xFF) * ia);
+        uint32_t r = div255(((fgColor >> 16) & 0xFF) * fa + ((bgColor >> 16) & 0xFF) * ia);
+        return 0xFF000000 | (r << 16) | (g << 8) | b;
+    }
+
+    // everything is scaled by 255 to keep fa * ba / 255 exact
+    uint32_t alphaOut = 255 * (fa + ba) - fa * ba;
+    if (alphaOut == 0) {
+        return 0;
+    }
 
-    float alphaMult = fg[3] * bg[3] / 255.0f;
-    float alphaOut = fg[3] + bg[3] - alphaMult;
+    uint32_t fa2 = 255 * fa;
+    uint32_t ba2 = 255 * ba - fa * ba;
+    uint32_t b = ((fgColor & 0xFF) * fa2 + (bgColor & 0xFF) * ba2) / alphaOut;
+    uint32_t g = (((fgColor >> 8) & 0xFF) * fa2 + ((bgColor >> 8) & 0xFF) * ba2) / alphaOut;
+    uint32_t r = (((fgColor >> 16) & 0xFF) * fa2 + ((bgColor >> 16) & 0xFF) * ba2) / alphaOut;
+    return (alphaOut / 255 << 24) | (r << 16) | (g << 8) | b;
+}
+
+static inline uint32_t withAlpha(uint32_t color, uint32_t alpha) {
+    return (color & 0x00FFFFFF) | (alpha << 24);
+}
 
-    float r = (fg[2] * fg[3] + bg[2] * bg[3] - bg[2] * alphaMult) / alphaOut;
-    float g = (fg[1] * fg[3] + bg[1] * bg[3] - bg[1] * alphaMult) / alphaOut;
-    float b = (fg[0] * fg[3] + bg[0] * bg[3] - bg[0] * alphaMult) / alphaOut;
+#if defined(BLEND_SSE2)
 
-    r = clamp(r, 0.0f, 255.0f);
-    g = clamp(g, 0.0f, 255.0f);
-    b = clamp(b, 0.0f, 255.0f);
+// Blends 4 pixels over opaque background, alpha is given in the low byte of each 32-bit lane.
+static inline __m128i blend4(__m128i fg, __m128i alpha, __m128i bg) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c255 = _mm_set1_epi16(255);
+    const __m128i c1 = _mm_set1_epi16(1);
 
-    uint32_t result;
-    uint8_t *presult = (uint8_t *)&result;
-    presult[0] = (uint8_t)b;
-    presult[1] = (uint8_t)g;
-    presult[2] = (uint8_t)r;
-    presult[3] = (uint8_t)alphaOut;
+    alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 8));
+    alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
 
-    return result;
+    __m128i aLo = _mm_unpacklo_epi8(alpha, zero);
+    __m128i aHi = _mm_unpackhi_epi8(alpha, zero);
+
+    __m128i lo = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpacklo_epi8(fg, zero), aLo),
+        _mm_mullo_epi16(_mm_unpacklo_epi8(bg, zero), _mm_sub_epi16(c255, aLo)));
+    __m128i hi = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpackhi_epi8(fg, zero), aHi),
+        _mm_mullo_epi16(_mm_unpackhi_epi8(bg, zero), _mm_sub_epi16(c255, aHi)));
+
+    lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, c1), _mm_srli_epi16(lo, 8)), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, c1), _mm_srli_epi16(hi, 8)), 8);
+
+    return _mm_or_si128(_mm_packus_epi16(lo, hi), _mm_set1_epi32(0xFF000000));
+}
+
+static inline bool isOpaque4(__m128i bg) {
+    const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(bg, alphaMask), alphaMask)) == 0xFFFF;
+}
+
+#elif defined(BLEND_NEON)
+
+static inline uint8x8_t blend2(uint8x8_t fg, uint8x8_t alpha, uint8x8_t bg) {
+    uint16x8_t n = vmlal_u8(vmull_u8(fg, alpha), bg, vsub_u8(vdup_n_u8(255), alpha));
+    n = vshrq_n_u16(vaddq_u16(vaddq_u16(n, vdupq_n_u16(1)), vshrq_n_u16(n, 8)), 8);
+    return vmovn_u16(n);
+}
+
+// Blends 4 pixels over opaque background, alpha is given in the low byte of each 32-bit lane.
+static inline uint32x4_t blend4(uint32x4_t fg, uint32x4_t alpha, uint32x4_t bg) {
+    uint8x16_t fg8 = vreinterpretq_u8_u32(fg);
+    uint8x16_t bg8 = vreinterpretq_u8_u32(bg);
+    uint8x16_t alpha8 = vreinterpretq_u8_u32(vmulq_n_u32(alpha, 0x01010101));
+
+    uint8x16_t result = vcombine_u8(
+        blend2(vget_low_u8(fg8), vget_low_u8(alpha8), vget_low_u8(bg8)),
+        blend2(vget_high_u8(fg8), vget_high_u8(alpha8), vget_high_u8(bg8)));
+
+    return vorrq_u32(vreinterpretq_u32_u8(result), vdupq_n_u32(0xFF000000));
+}
+
+static inline bool isOpaque4(uint32x4_t bg) {
+    uint32x4_t alpha = vshrq_n_u32(bg, 24);
+    return (vgetq_lane_u32(alpha, 0) & vgetq_lane_u32(alpha, 1) & vgetq_lane_u32(alpha, 2) & vgetq_lane_u32(alpha, 3)) == 255;
+}
+
+#endif
+
+static void fillRow(uint32_t *dst, int width, uint32_t color) {
+    for (uint32_t *dstEnd = dst + width; dst != dstEnd; dst++) {
+        *dst = color;
+    }
+}
+
+// Blends src row over dst row. Alpha of each src pixel is multiplied with opacity or,
+// if useSrcAlpha is false, replaced by opacity.
+static void blendRow(uint32_t *dst, const uint32_t *src, int width, uint32_t opacity, bool useSrcAlpha) {
+    int i = 0;
+
+#if defined(BLEND_SSE2)
+    const __m128i opacity4 = _mm_set1_epi32(opacity);
+    const __m128i c1 = _mm_set1_epi32(1);
+    for (; i + 4 <= width; i += 4) {
+        __m128i bg = _mm_loadu_si128((const __m128i *)(dst + i));
+        if (!isOpaque4(bg)) {
+            for (int j = i; j < i + 4; j++) {
+                dst[j] = blendColor(withAlpha(src[j], useSrcAlpha ? div255((src[j] >> 24) * opacity) : opacity), dst[j]);
+            }
+            continue;
+        }
+        __m128i fg = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i alpha = opacity4;
+        if (useSrcAlpha) {
+            __m128i n = _mm_mullo_epi16(_mm_srli_epi32(fg, 24), opacity4);
+            alpha = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(n, c1), _mm_srli_epi32(n, 8)), 8);
+        }
+        _mm_storeu_si128((__m128i *)(dst + i), blend4(fg, alpha, bg));
+    }
+#elif defined(BLEND_NEON)
+    const uint32x4_t opacity4 = vdupq_n_u32(opacity);
+    for (; i + 4 <= width; i += 4) {
+        uint32x4_t bg = vld1q_u32(dst + i);
+        if (!isOpaque4(bg)) {
+            for (int j = i; j < i + 4; j++) {
+                dst[j] = blendColor(withAlpha(src[j], useSrcAlpha ? div255((src[j] >> 24) * opacity) : opacity), dst[j]);
+            }
+            continue;
+        }
+        uint32x4_t fg = vld1q_u32(src + i);
+        uint32x4_t alpha = opacity4;
+        if (useSrcAlpha) {
+            uint32x4_t n = vmulq_u32(vshrq_n_u32(fg, 24), opacity4);
+            alpha = vshrq_n_u32(vaddq_u32(vaddq_u32(n, vdupq_n_u32(1)), vshrq_n_u32(n, 8)), 8);
+        }
+        vst1q_u32(dst + i, blend4(fg, alpha, bg));
+    }
+#endif
+
+    for (; i < width; i++) {
+        dst[i] = blendColor(withAlpha(src[i], useSrcAlpha ? div255((src[i] >> 24) * opacity) : opacity), dst[i]);
+    }
+}
+
+// Blends color over dst row using 8-bit glyph coverage as alpha.
+static void blendGlyphRow(uint32_t *dst, const uint8_t *coverage, int width, uint32_t color) {
+    int i = 0;
+
+#if defined(BLEND_SSE2)
+    const __m128i color4 = _mm_set1_epi32(color);
+    for (; i + 4 <= width; i += 4) {
+        __m128i bg = _mm_loadu_si128((const __m128i *)(dst + i));
+        if (!isOpaque4(bg)) {
+            for (int j = i; j < i + 4; j++) {
+                dst[j] = blendColor(withAlpha(color, coverage[j]), dst[j]);
+            }
+            continue;
+        }
+        __m128i alpha = _mm_setr_epi32(coverage[i], coverage[i + 1], coverage[i + 2], coverage[i + 3]);
+        _mm_storeu_si128((__m128i *)(dst + i), blend4(color4, alpha, bg));
+    }
+#elif defined(BLEND_NEON)
+    const uint32x4_t color4 = vdupq_n_u32(color);
+    for (; i + 4 <= width; i += 4) {
+        uint32x4_t bg = vld1q_u32(dst + i);
+        if (!isOpaque4(bg)) {
+            for (int j = i; j < i + 4; j++) {
+                dst[j] = blendColor(withAlpha(color, coverage[j]), dst[j]);
+            }
+            continue;
+        }
+        uint32_t a[4] = { coverage[i], coverage[i + 1], coverage[i + 2], coverage[i + 3] };
+        vst1q_u32(dst + i, blend4(color4, vld1q_u32(a), bg));
+    }
+#endif
+
+    for (; i < width; i++) {
+        dst[i] = blendColor(withAlpha(color, coverage[i]), dst[i]);
+    }
 }
 
 static uint32_t color16to32(uint16_t color) {
@@ -105,6 +312,87 @@ static uint32_t color16to32(uint16_t color) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static bool isVramBuffer(void *buffer) {
+    return buffer == VRAM_BUFFER1_START_ADDRESS || buffer == VRAM_BUFFER2_START_ADDRESS;
+}
+
+// Drawing into aux buffers is not tracked, those are marked dirty when composed into VRAM buffer.
+static void markDirty(void *buffer, int x1, int y1, int x2, int y2) {
+    if (!isVramBuffer(buffer)) {
+        return;
+    }
+
+    if (x1 < 0) {
+        x1 = 0;
+    }
+    if (y1 < 0) {
+        y1 = 0;
+    }
+    if (x2 > (int)DISPLAY_WIDTH - 1) {
+        x2 = DISPLAY_WIDTH - 1;
+    }
+    if (y2 > (int)DISPLAY_HEIGHT - 1) {
+        y2 = DISPLAY_HEIGHT - 1;
+    }
+    if (x1 > x2 || y1 > y2) {
+        return;
+    }
+
+    DirtyRegion &region = *g_dirtyRegion;
+
+    for (int i = 0; i < region.numRects; i++) {
+        DirtyRect &rect = region.rects[i];
+        if (x1 >= rect.x1 && y1 >= rect.y1 && x2 <= rect.x2 && y2 <= rect.y2) {
+            return;
+        }
+        if (x1 <= rect.x1 && y1 <= rect.y1 && x2 >= rect.x2 && y2 >= rect.y2) {
+            rect.x1 = x1;
+            rect.y1 = y1;
+            rect.x2 = x2;
+            rect.y2 = y2;
+            return;
+        }
+    }
+
+    if (region.numRects < MAX_DIRTY_RECTS) {
+        DirtyRect &rect = region.rects[region.numRects++];
+        rect.x1 = x1;
+        rect.y1 = y1;
+        rect.x2 = x2;
+        rect.y2 = y2;
+        return;
+    }
+
+    // too many rectangles, collapse all into the bounding rectangle
+    DirtyRect &rect = region.rects[0];
+    for (int i = 1; i < region.numRects; i++) {
+        rect.x1 = MIN(rect.x1, region.rects[i].x1);
+        rect.y1 = MIN(rect.y1, region.rects[i].y1);
+        rect.x2 = MAX(rect.x2, region.rects[i].x2);
+        rect.y2 = MAX(rect.y2, region.rects[i].y2);
+    }
+    rect.x1 = MIN(rect.x1, x1);
+    rect.y1 = MIN(rect.y1, y1);
+    rect.x2 = MAX(rect.x2, x2);
+    rect.y2 = MAX(rect.y2, y2);
+    region.numRects = 1;
+}
+
+static void swapBuffers() {
+    if (g_buffer == (uint32_t *)VRAM_BUFFER1_START_ADDRESS) {
+        g_buffer = (uint32_t *)VRAM_BUFFER2_START_ADDRESS;
+    } else {
+        g_buffer = (uint32_t *)VRAM_BUFFER1_START_ADDRESS;
+    }
+
+    DirtyRegion *region = g_previousDirtyRegion;
+    g_previousDirtyRegion = g_dirtyRegion;
+    g_dirtyRegion = region;
+    g_dirtyRegion->numRects = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 // heuristics to find resource file
 std::string getFullPath(std::string category, std::string path) {
     std::string fullPath = category + "/" + path;
@@ -119,6 +407,7 @@ std::string getFullPath(std::string category, std::string path) {
     return path;
 }
 
+#if !defined(EEZ_PLATFORM_SIMULATOR_HEADLESS)
 int getDesktopResolution(int *w, int *h) {
     SDL_Init(SDL_INIT_VIDEO);
 
@@ -137,6 +426,10 @@ int getDesktopResolution(int *w, int *h) {
 }
 
 bool init() {
+    if (g_headless) {
+        return true;
+    }
+
     // Set texture filtering to linear
     if (!SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "1")) {
         printf("Warning: Linear texture filtering not enabled!");
@@ -181,6 +474,11 @@ bool init() {
 
     return true;
 }
+#else
+bool init() {
+    return true;
+}
+#endif
 
 #if OPTION_SDRAM
 void *getBufferPointer() {
@@ -202,6 +500,10 @@ void turnOn() {
 
         g_buffer = (uint32_t *)VRAM_BUFFER1_START_ADDRESS;
 
+        g_dirtyRegions[0].numRects = 0;
+        g_dirtyRegions[1].numRects = 0;
+        g_fullUpload = true;
+
         g_buffers[0].bufferPointer = (uint32_t *)VRAM_AUX_BUFFER1_START_ADDRESS;
         g_buffers[1].bufferPointer = (uint32_t *)VRAM_AUX_BUFFER2_START_ADDRESS;
         g_buffers[2].bufferPointer = (uint32_t *)VRAM_AUX_BUFFER3_START_ADDRESS;
@@ -242,25 +544,42 @@ void updateScreen(uint32_t *buffer) {
         return;
     }
 
-    SDL_Surface *rgbSurface = SDL_CreateRGBSurfaceFrom(
-        buffer, DISPLAY_WIDTH, DISPLAY_HEIGHT, 32, 4 * DISPLAY_WIDTH, 0, 0, 0, 0);
-    if (rgbSurface != NULL) {
-        SDL_Texture *texture = SDL_CreateTextureFromSurface(g_renderer, rgbSurface);
-        if (texture != NULL) {
-            SDL_Rect srcRect = { 0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT };
-            SDL_Rect dstRect = { 0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT };
-
-            SDL_RenderCopyEx(g_renderer, texture, &srcRect, &dstRect, 0.0, NULL, SDL_FLIP_NONE);
+#if !defined(EEZ_PLATFORM_SIMULATOR_HEADLESS)
+    if (g_headless) {
+        return;
+    }
 
-            SDL_DestroyTexture(texture);
-        } else {
-            printf("Unable to create texture from image buffer! SDL Error: %s\n", SDL_GetError());
+    if (g_texture == NULL) {
+        g_texture = SDL_CreateTexture(g_renderer, SDL_PIXELFORMAT_RGB888, SDL_TEXTUREACCESS_STREAMING, DISPLAY_WIDTH, DISPLAY_HEIGHT);
+        if (g_texture == NULL) {
+            printf("Unable to create texture! SDL Error: %s\n", SDL_GetError());
+            return;
         }
-        SDL_FreeSurface(rgbSurface);
+        g_fullUpload = true;
+    }
+
+    if (buffer != g_buffer) {
+        // animation frame, not tracked
+        g_fullUpload = true;
+    }
+
+    if (g_fullUpload) {
+        SDL_UpdateTexture(g_texture, NULL, buffer, 4 * DISPLAY_WIDTH);
+        g_fullUpload = buffer != g_buffer;
     } else {
-        printf("Unable to render text surface! SDL Error: %s\n", SDL_GetError());
+        for (int i = 0; i < 2; i++) {
+            DirtyRegion &region = g_dirtyRegions[i];
+            for (int j = 0; j < region.numRects; j++) {
+                DirtyRect &rect = region.rects[j];
+                SDL_Rect sdlRect = { rect.x1, rect.y1, rect.x2 - rect.x1 + 1, rect.y2 - rect.y1 + 1 };
+                SDL_UpdateTexture(g_texture, &sdlRect, buffer + rect.y1 * DISPLAY_WIDTH + rect.x1, 4 * DISPLAY_WIDTH);
+            }
+        }
     }
+
+    SDL_RenderCopy(g_renderer, g_texture, NULL, NULL);
     SDL_RenderPresent(g_renderer);
+#endif
 }
 
 void animate() {
@@ -308,7 +627,44 @@ void doTakeScreenshot() {
 
 }
 
+// Without the window there is no need for the frame pacing and GUI is drawn
+// (and buffers are swapped) only when screenshot is requested.
+static void syncHeadless() {
+    g_animationState.enabled = false;
+
+    if (!isOn()) {
+        return;
+    }
+
+    if (g_painted) {
+        g_painted = false;
+
+        updateScreen(g_buffer);
+
+        swapBuffers();
+    }
+
+    if (g_takeScreenshot) {
+        if (g_screenshotFrameDrawn) {
+            g_screenshotFrameDrawn = false;
+            doTakeScreenshot();
+        } else {
+            g_screenshotFrameDrawn = true;
+        }
+    }
+}
+
+bool isDrawingEnabled() {
+    return !g_headless || g_screenshotFrameDrawn;
+}
+
 void sync() {
+    if (g_headless) {
+        syncHeadless();
+        return;
+    }
+
+#if !defined(EEZ_PLATFORM_SIMULATOR_HEADLESS)
     static uint32_t g_lastTickCount;
     uint32_t tickCount = millis();
     int32_t diff = 1000 / 60 - (tickCount - g_lastTickCount);
@@ -324,6 +680,7 @@ void sync() {
     if (g_mainWindow == nullptr) {
         init();
     }
+#endif
 
     if (g_animationState.enabled) {
         animate();
@@ -343,11 +700,7 @@ void sync() {
 
         updateScreen(g_buffer);
 
-        if (g_buffer == (uint32_t *)VRAM_BUFFER1_START_ADDRESS) {
-            g_buffer = (uint32_t *)VRAM_BUFFER2_START_ADDRESS;
-        } else {
-            g_buffer = (uint32_t *)VRAM_BUFFER1_START_ADDRESS;
-        }
+        swapBuffers();
     }
 
 }
@@ -355,11 +708,7 @@ void sync() {
 void finishAnimation() {
     updateScreen(g_buffer);
 
-    if (g_buffer == (uint32_t *)VRAM_BUFFER1_START_ADDRESS) {
-        g_buffer = (uint32_t *)VRAM_BUFFER2_START_ADDRESS;
-    } else {
-        g_buffer = (uint32_t *)VRAM_BUFFER1_START_ADDRESS;
-    }
+    swapBuffers();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -391,23 +740,15 @@ const uint8_t *takeScreenshot() {
 ////////////////////////////////////////////////////////////////////////////////
 
 static void doDrawGlyph(const gui::font::Glyph &glyph, int x_glyph, int y_glyph, int width, int height, int offset, int iStartByte) {
-    uint32_t pixel;
-    ((uint8_t *)&pixel)[0] = COLOR_TO_B(g_fc);
-    ((uint8_t *)&pixel)[1] = COLOR_TO_G(g_fc);
-    ((uint8_t *)&pixel)[2] = COLOR_TO_R(g_fc);
-    uint8_t *pixelAlpha = ((uint8_t *)&pixel) + 3;
+    uint32_t color32 = color16to32(g_fc);
 
     const uint8_t *src = glyph.data + offset + iStartByte;
-    int nlSrc = glyph.width - width;
-
     uint32_t *dst = g_buffer + y_glyph * DISPLAY_WIDTH + x_glyph;
-    int nlDst = DISPLAY_WIDTH - width;
 
-    for (const uint8_t *srcEnd = src + height * glyph.width; src != srcEnd; src += nlSrc, dst += nlDst) {
-        for (uint32_t *dstEnd = dst + width; dst != dstEnd; src++, dst++) {
-            *pixelAlpha = *src;
-            *dst = blendColor(pixel, *dst);
-        }
+    markDirty(g_buffer, x_glyph, y_glyph, x_glyph + width - 1, y_glyph + height - 1);
+
+    for (int y = 0; y < height; y++, src += glyph.width, dst += DISPLAY_WIDTH) {
+        blendGlyphRow(dst, src, width, color32);
     }
 }
 
@@ -464,6 +805,8 @@ static int8_t drawGlyph(int x1, int y1, int clip_x1, int clip_y1, int clip_x2, i
 void drawPixel(int x, int y) {
     *(g_buffer + y * DISPLAY_WIDTH + x) = color16to32(g_fc);
 
+    markDirty(g_buffer, x, y, x, y);
+
     g_painted = true;
 }
 
@@ -485,15 +828,13 @@ void drawRect(int x1, int y1, int x2, int y2) {
 
 void fillRect(int x1, int y1, int x2, int y2, int r) {
     if (r == 0) {
+        markDirty(g_buffer, x1, y1, x2, y2);
+
         uint32_t color32 = color16to32(g_fc);
         uint32_t *dst = g_buffer + y1 * DISPLAY_WIDTH + x1;
         int width = x2 - x1 + 1;
-        int height = y2 - y1 + 1;
-        int nl = DISPLAY_WIDTH - width;
-        for (uint32_t *dstEnd = dst + height * DISPLAY_WIDTH; dst != dstEnd; dst += nl) {
-            for (uint32_t *lineEnd = dst + width; dst != lineEnd; dst++) {
-                *dst = color32;
-            }
+        for (int y = y1; y <= y2; y++, dst += DISPLAY_WIDTH) {
+            fillRow(dst, width, color32);
         }
     } else {
         // draw rounded rect
@@ -515,14 +856,13 @@ void fillRect(int x1, int y1, int x2, int y2, int r) {
 }
 
 void fillRect(void *dstBuffer, int x1, int y1, int x2, int y2) {
+    markDirty(dstBuffer, x1, y1, x2, y2);
+
     uint32_t color32 = color16to32(g_fc);
     uint32_t *dst = (uint32_t *)dstBuffer + y1 * DISPLAY_WIDTH + x1;
-    int nl = DISPLAY_WIDTH - (x2 - x1 + 1);
-    for (int y = y1; y <= y2; y++) {
-        for (int x = x1; x <= x2; x++) {
-            *dst++ = color32;
-        }
-        dst += nl;
+    int width = x2 - x1 + 1;
+    for (int y = y1; y <= y2; y++, dst += DISPLAY_WIDTH) {
+        fillRow(dst, width, color32);
     }
 }
 
@@ -531,6 +871,8 @@ void drawHLine(int x, int y, int l) {
 
     uint32_t *dst = g_buffer + y * DISPLAY_WIDTH + x;
     uint32_t *dstEnd = dst + l + 1;
+
+    markDirty(g_buffer, x, y, x + l, y);
     while (dst < dstEnd) {
         *dst++ = color32;
     }
@@ -544,6 +886,8 @@ void drawVLine(int x, int y, int l) {
     uint32_t *dst = g_buffer + y * DISPLAY_WIDTH + x;
     uint32_t *dstEnd = dst + (l + 1) * DISPLAY_WIDTH;
 
+    markDirty(g_buffer, x, y, x, y + l);
+
     while (dst < dstEnd) {
         *dst = color32;
         dst += DISPLAY_WIDTH;
@@ -560,6 +904,8 @@ void bitBlt(int x1, int y1, int x2, int y2, int dstx, int dsty) {
     uint32_t *dst = g_buffer + dsty * DISPLAY_WIDTH + dstx;
     int nl = DISPLAY_WIDTH - width;
 
+    markDirty(g_buffer, dstx, dsty, dstx + width - 1, dsty + height - 1);
+
     for (int y = y1; y <= y2; y++, src += nl, dst += nl) {
         for (uint32_t *lineEnd = dst + width; dst != lineEnd; dst++, src++) {
             uint8_t *src8 = (uint8_t *)src;
@@ -575,11 +921,11 @@ void bitBlt(void *src, int x1, int y1, int x2, int y2) {
 }
 
 void bitBlt(void *src, void *dst, int x1, int y1, int x2, int y2) {
+    markDirty(dst, x1, y1, x2, y2);
+
     for (int y = y1; y <= y2; ++y) {
-        for (int x = x1; x <= x2; ++x) {
-            int i = y * DISPLAY_WIDTH + x;
-            ((uint32_t *)dst)[i] = ((uint32_t *)src)[i];
-        }
+        int i = y * DISPLAY_WIDTH + x1;
+        memcpy((uint32_t *)dst + i, (uint32_t *)src + i, (x2 - x1 + 1) * 4);
     }
 }
 
@@ -588,22 +934,15 @@ void bitBlt(void *src, void *dst, int sx, int sy, int sw, int sh, int dx, int dy
         dst = g_buffer;
     }
 
-    if (opacity == 255) {
-        for (int y = 0; y < sh; ++y) {
-            for (int x = 0; x < sw; ++x) {
-                ((uint32_t *)dst)[(dy + y) * DISPLAY_WIDTH + dx + x] = ((uint32_t *)src)[(sy + y) * DISPLAY_WIDTH + sx + x];
-            }
-        }
-    } else {
-        for (int y = 0; y < sh; ++y) {
-            for (int x = 0; x < sw; ++x) {
-                uint8_t *p = (uint8_t *)&((uint32_t *)src)[(sy + y) * DISPLAY_WIDTH + sx + x];
-                p[3] = opacity;
-                ((uint32_t *)dst)[(dy + y) * DISPLAY_WIDTH + dx + x] = blendColor(
-                    ((uint32_t *)src)[(sy + y) * DISPLAY_WIDTH + sx + x],
-                    ((uint32_t *)dst)[(dy + y) * DISPLAY_WIDTH + dx + x]
-                );
-            }
+    markDirty(dst, dx, dy, dx + sw - 1, dy + sh - 1);
+
+    for (int y = 0; y < sh; ++y) {
+        uint32_t *dstRow = (uint32_t *)dst + (dy + y) * DISPLAY_WIDTH + dx;
+        uint32_t *srcRow = (uint32_t *)src + (sy + y) * DISPLAY_WIDTH + sx;
+        if (opacity == 255) {
+            memcpy(dstRow, srcRow, sw * 4);
+        } else {
+            blendRow(dstRow, srcRow, sw, opacity, false);
         }
     }
 }
@@ -612,19 +951,12 @@ void drawBitmap(void *bitmapData, int bitmapBpp, int bitmapWidth, int x, int y,
     uint32_t *dst = g_buffer + y * DISPLAY_WIDTH + x;
     int nlDst = DISPLAY_WIDTH - width;
 
+    markDirty(g_buffer, x, y, x + width - 1, y + height - 1);
+
     if (bitmapBpp == 32) {
         uint32_t *src = (uint32_t *)bitmapData;
-        int nlSrc = bitmapWidth - width;
-
-        uint32_t pixel;
-        uint8_t *pixelAlpha = ((uint8_t *)&pixel) + 3;
-
-        for (uint32_t *srcEnd = src + bitmapWidth * height; src != srcEnd; src += nlSrc, dst += nlDst) {
-            for (uint32_t *lineEnd = dst + width; dst != lineEnd; src++, dst++) {
-                pixel = *src;
-                *pixelAlpha = *pixelAlpha * g_opacity / 255;
-                *dst = blendColor(pixel, *dst);
-            }
+        for (int i = 0; i < height; i++, src += bitmapWidth, dst += DISPLAY_WIDTH) {
+            blendRow(dst, src, width, g_opacity, true);
         }
     } else if (bitmapBpp == 24) {
         uint8_t *src = (uint8_t *)bitmapData;
@@ -671,6 +1003,83 @@ void drawStr(const char *text, int textLength, int x, int y, int clip_x1, int cl
     g_painted = true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+static volatile uint32_t g_benchmarkSink;
+
+bool benchmark(int numFrames, float &fillMpixelsPerSecond, float &blitMpixelsPerSecond, float &blendMpixelsPerSecond, float &textMpixelsPerSecond) {
+    // measure on the buffers of the size of the application view, GUI keeps drawing into VRAM buffers meanwhile
+    const int width = 480;
+    const int height = 272;
+
+    uint32_t *dstBuffer = (uint32_t *)malloc(width * height * 4);
+    uint32_t *srcBuffer = (uint32_t *)malloc(width * height * 4);
+    uint8_t *coverage = (uint8_t *)malloc(width);
+    if (!dstBuffer || !srcBuffer || !coverage) {
+        free(dstBuffer);
+        free(srcBuffer);
+        free(coverage);
+        return false;
+    }
+
+    for (int i = 0; i < width * height; i++) {
+        srcBuffer[i] = 0xFF000000 | (i * 2654435761u >> 8);
+    }
+
+    // antialiased glyph edges, i.e. mix of transparent, opaque and partial coverage
+    for (int i = 0; i < width; i++) {
+        coverage[i] = (i % 8) < 3 ? 0 : (i % 8) < 6 ? 255 : (uint8_t)(i * 37);
+    }
+
+    uint32_t start = micros();
+    for (int frame = 0; frame < numFrames; frame++) {
+        for (int y = 0; y < height; y++) {
+            fillRow(dstBuffer + y * width, width, 0xFF000000 | frame);
+        }
+    }
+    uint32_t fillDuration = micros() - start;
+    g_benchmarkSink = dstBuffer[width * height - 1];
+
+    start = micros();
+    for (int frame = 0; frame < numFrames; frame++) {
+        for (int y = 0; y < height; y++) {
+            memcpy(dstBuffer + y * width, srcBuffer + y * width, width * 4);
+        }
+    }
+    uint32_t blitDuration = micros() - start;
+    g_benchmarkSink = dstBuffer[width * height - 1];
+
+    start = micros();
+    for (int frame = 0; frame < numFrames; frame++) {
+        for (int y = 0; y < height; y++) {
+            blendRow(dstBuffer + y * width, srcBuffer + y * width, width, 128, false);
+        }
+    }
+    uint32_t blendDuration = micros() - start;
+    g_benchmarkSink = dstBuffer[width * height - 1];
+
+    start = micros();
+    for (int frame = 0; frame < numFrames; frame++) {
+        for (int y = 0; y < height; y++) {
+            blendGlyphRow(dstBuffer + y * width, coverage, width, 0xFFFFFFFF);
+        }
+    }
+    uint32_t textDuration = micros() - start;
+    g_benchmarkSink = dstBuffer[width * height - 1];
+
+    free(dstBuffer);
+    free(srcBuffer);
+    free(coverage);
+
+    float numPixels = 1.0f * numFrames * width * height;
+    fillMpixelsPerSecond = numPixels / MAX(fillDuration, 1);
+    blitMpixelsPerSecond = numPixels / MAX(blitDuration, 1);
+    blendMpixelsPerSecond = numPixels / MAX(blendDuration, 1);
+    textMpixelsPerSecond = numPixels / MAX(textDuration, 1);
+
+    return true;
+}
+
 } // namespace display
 } // namespace mcu
 } // namespace eez
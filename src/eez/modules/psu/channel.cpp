@@ -35,6 +35,7 @@
 #include <eez/scpi/regs.h>
 #include <eez/sound.h>
 #include <eez/index.h>
+#include <eez/memory.h>
 
 #include <eez/modules/bp3c/relays.h>
 
@@ -49,6 +50,48 @@ namespace psu {
 int CH_NUM = 0;
 Channel Channel::g_channels[CH_MAX];
 
+struct ChannelHistory {
+    Channel::HistoryValue u[CHANNEL_HISTORY_SIZE];
+    Channel::HistoryValue i[CHANNEL_HISTORY_SIZE];
+    Channel::HistoryValue p[CHANNEL_HISTORY_SIZE];
+};
+
+static_assert(CH_MAX * sizeof(ChannelHistory) <= CHANNEL_HISTORY_BUFFER_SIZE, "CHANNEL_HISTORY_BUFFER too small");
+
+static ChannelHistory * const g_history = (ChannelHistory *)CHANNEL_HISTORY_BUFFER;
+
+static void resetHistoryAccumulator(Channel::HistoryAccumulator &accumulator) {
+    accumulator.min = INFINITY;
+    accumulator.max = -INFINITY;
+    accumulator.sum = 0;
+    accumulator.count = 0;
+}
+
+static void addHistoryValue(Channel::HistoryAccumulator &accumulator, float value) {
+    if (value < accumulator.min) {
+        accumulator.min = value;
+    }
+    if (value > accumulator.max) {
+        accumulator.max = value;
+    }
+    accumulator.sum += value;
+    accumulator.count++;
+}
+
+static void storeHistoryValue(Channel::HistoryAccumulator &accumulator, float lastValue, Channel::HistoryValue &historyValue) {
+    if (accumulator.count > 0) {
+        historyValue.min = accumulator.min;
+        historyValue.max = accumulator.max;
+        historyValue.mean = accumulator.sum / accumulator.count;
+        resetHistoryAccumulator(accumulator);
+    } else {
+        // no ADC sample during this slot (e.g. view rate is faster than ADC), repeat the last value
+        historyValue.min = lastValue;
+        historyValue.max = lastValue;
+        historyValue.mean = lastValue;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void Channel::Value::init(float set_, float step_, float limit_) {
@@ -166,148 +209,131 @@ void Channel::restoreOE() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-float Channel::getChannel0HistoryValue(int rowIndex, int columnIndex, float *max) {
-    Channel &channel = g_channels[0];
+void Channel::StatisticsValue::reset() {
+    min = INFINITY;
+    max = -INFINITY;
+    sum = 0;
+    sumOfSquares = 0;
+    count = 0;
+}
 
-    uint32_t position = rowIndex % CHANNEL_HISTORY_SIZE;
-    
-    if (columnIndex == 0) {
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_VOLTAGE) {
-            return channel.uHistory[position];
-        }
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_CURRENT) {
-            return channel.iHistory[position];
-        }
-    } else {
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_VOLTAGE) {
-            return channel.uHistory[position];
-        }
-        if (g_channels[0].flags.displayValue2 == DISPLAY_VALUE_CURRENT) {
-            return channel.iHistory[position];
-        }
+void Channel::StatisticsValue::add(float value) {
+    if (value < min) {
+        min = value;
+    }
+    if (value > max) {
+        max = value;
     }
+    sum += value;
+    sumOfSquares += (double)value * value;
+    count++;
+}
 
-    return channel.uHistory[position] * channel.iHistory[position];
+float Channel::StatisticsValue::getMin() const {
+    return count > 0 ? min : NAN;
 }
 
-float Channel::getChannel1HistoryValue(int rowIndex, int columnIndex, float *max) {
-    Channel &channel = g_channels[1];
+float Channel::StatisticsValue::getMax() const {
+    return count > 0 ? max : NAN;
+}
 
-    uint32_t position = rowIndex % CHANNEL_HISTORY_SIZE;
+float Channel::StatisticsValue::getMean() const {
+    return count > 0 ? (float)(sum / count) : NAN;
+}
 
-    if (columnIndex == 0) {
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_VOLTAGE) {
-            return channel.uHistory[position];
-        }
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_CURRENT) {
-            return channel.iHistory[position];
-        }
-    } else {
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_VOLTAGE) {
-            return channel.uHistory[position];
-        }
-        if (g_channels[0].flags.displayValue2 == DISPLAY_VALUE_CURRENT) {
-            return channel.iHistory[position];
-        }
-    }
+float Channel::StatisticsValue::getRms() const {
+    return count > 0 ? (float)sqrt(sumOfSquares / count) : NAN;
+}
 
-    return channel.uHistory[position] * channel.iHistory[position];
+float Channel::Statistics::getDuration() const {
+    return (millis() - resetTime) / 1000.0f;
 }
 
-float Channel::getChannel2HistoryValue(int rowIndex, int columnIndex, float *max) {
-    Channel &channel = g_channels[2];
+void Channel::resetStatistics() {
+    statisticsResetRequested = true;
+}
 
-    uint32_t position = rowIndex % CHANNEL_HISTORY_SIZE;
+void Channel::doResetStatistics() {
+    statistics.u.reset();
+    statistics.i.reset();
+    statistics.ampHours = 0;
+    statistics.wattHours = 0;
+    statistics.resetTime = millis();
+    statistics.integrating = false;
+}
 
-    if (columnIndex == 0) {
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_VOLTAGE) {
-            return channel.uHistory[position];
-        }
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_CURRENT) {
-            return channel.iHistory[position];
-        }
-    } else {
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_VOLTAGE) {
-            return channel.uHistory[position];
-        }
-        if (g_channels[0].flags.displayValue2 == DISPLAY_VALUE_CURRENT) {
-            return channel.iHistory[position];
-        }
-    }
+void Channel::addStatisticsCurrentValue(float iMon) {
+    statistics.i.add(iMon);
 
-    return channel.uHistory[position] * channel.iHistory[position];
+    // charge and energy are integrated between two consecutive I_MON conversions
+    uint32_t currentSampleTime = micros();
+    if (statistics.integrating) {
+        double hours = (currentSampleTime - statistics.lastCurrentSampleTime) / 3600000000.0;
+        statistics.ampHours += iMon * hours;
+        statistics.wattHours += channel_dispatcher::getUMonLast(*this) * iMon * hours;
+    }
+    statistics.lastCurrentSampleTime = currentSampleTime;
+    statistics.integrating = true;
 }
 
-float Channel::getChannel3HistoryValue(int rowIndex, int columnIndex, float *max) {
-    Channel &channel = g_channels[3];
+////////////////////////////////////////////////////////////////////////////////
 
+float Channel::getHistoryValue(Channel &channel, int rowIndex, int columnIndex, float *max) {
     uint32_t position = rowIndex % CHANNEL_HISTORY_SIZE;
 
-    if (columnIndex == 0) {
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_VOLTAGE) {
-            return channel.uHistory[position];
-        }
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_CURRENT) {
-            return channel.iHistory[position];
-        }
-    } else {
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_VOLTAGE) {
-            return channel.uHistory[position];
+    const HistoryValue &u = g_history[channel.channelIndex].u[position];
+    const HistoryValue &i = g_history[channel.channelIndex].i[position];
+    const HistoryValue &p = g_history[channel.channelIndex].p[position];
+
+    unsigned displayValue = columnIndex == 0 ? channel.flags.displayValue1 : channel.flags.displayValue2;
+
+    // when max is requested return the envelope (min is returned, max is stored in *max),
+    // otherwise return the mean value
+    if (displayValue == DISPLAY_VALUE_VOLTAGE) {
+        if (max) {
+            *max = u.max;
+            return u.min;
         }
-        if (g_channels[0].flags.displayValue2 == DISPLAY_VALUE_CURRENT) {
-            return channel.iHistory[position];
+        return u.mean;
+    }
+
+    if (displayValue == DISPLAY_VALUE_CURRENT) {
+        if (max) {
+            *max = i.max;
+            return i.min;
         }
+        return i.mean;
     }
 
-    return channel.uHistory[position] * channel.iHistory[position];
+    if (max) {
+        *max = p.max;
+        return p.min;
+    }
+    return p.mean;
 }
 
-float Channel::getChannel4HistoryValue(int rowIndex, int columnIndex, float *max) {
-    Channel &channel = g_channels[4];
-
-    uint32_t position = rowIndex % CHANNEL_HISTORY_SIZE;
-
-    if (columnIndex == 0) {
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_VOLTAGE) {
-            return channel.uHistory[position];
-        }
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_CURRENT) {
-            return channel.iHistory[position];
-        }
-    } else {
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_VOLTAGE) {
-            return channel.uHistory[position];
-        }
-        if (g_channels[0].flags.displayValue2 == DISPLAY_VALUE_CURRENT) {
-            return channel.iHistory[position];
-        }
-    }
+float Channel::getChannel0HistoryValue(int rowIndex, int columnIndex, float *max) {
+    return getHistoryValue(g_channels[0], rowIndex, columnIndex, max);
+}
 
-    return channel.uHistory[position] * channel.iHistory[position];
+float Channel::getChannel1HistoryValue(int rowIndex, int columnIndex, float *max) {
+    return getHistoryValue(g_channels[1], rowIndex, columnIndex, max);
 }
 
-float Channel::getChannel5HistoryValue(int rowIndex, int columnIndex, float *max) {
-    Channel &channel = g_channels[5];
+float Channel::getChannel2HistoryValue(int rowIndex, int columnIndex, float *max) {
+    return getHistoryValue(g_channels[2], rowIndex, columnIndex, max);
+}
 
-    uint32_t position = rowIndex % CHANNEL_HISTORY_SIZE;
+float Channel::getChannel3HistoryValue(int rowIndex, int columnIndex, float *max) {
+    return getHistoryValue(g_channels[3], rowIndex, columnIndex, max);
+}
 
-    if (columnIndex == 0) {
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_VOLTAGE) {
-            return channel.uHistory[position];
-        }
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_CURRENT) {
-            return channel.iHistory[position];
-        }
-    } else {
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_VOLTAGE) {
-            return channel.uHistory[position];
-        }
-        if (g_channels[0].flags.displayValue2 == DISPLAY_VALUE_CURRENT) {
-            return channel.iHistory[position];
-        }
-    }
+float Channel::getChannel4HistoryValue(int rowIndex, int columnIndex, float *max) {
+    return getHistoryValue(g_channels[4], rowIndex, columnIndex, max);
+}
 
-    return channel.uHistory[position] * channel.iHistory[position];
+float Channel::getChannel5HistoryValue(int rowIndex, int columnIndex, float *max) {
+    return getHistoryValue(g_channels[5], rowIndex, columnIndex, max);
 }
 
 Channel::YtDataGetValueFunctionPointer Channel::getChannelHistoryValueFuncs(int channelIndex) {
@@ -609,6 +635,7 @@ void Channel::reset() {
     p_limit = roundChannelValue(UNIT_WATT, params.PTOT);
 
     resetHistory();
+    resetStatistics();
 
     flags.displayValue1 = DISPLAY_VALUE_VOLTAGE;
     flags.displayValue2 = DISPLAY_VALUE_CURRENT;
@@ -631,13 +658,26 @@ void Channel::reset() {
 }
 
 void Channel::resetHistory() {
+    ChannelHistory &history = g_history[channelIndex];
     for (int i = 0; i < CHANNEL_HISTORY_SIZE; ++i) {
-        uHistory[i] = NAN;
-        iHistory[i] = NAN;
+        history.u[i].min = history.u[i].max = history.u[i].mean = NAN;
+        history.i[i].min = history.i[i].max = history.i[i].mean = NAN;
+        history.p[i].min = history.p[i].max = history.p[i].mean = NAN;
     }
+    resetHistoryAccumulator(uHistoryAccumulator);
+    resetHistoryAccumulator(iHistoryAccumulator);
+    resetHistoryAccumulator(pHistoryAccumulator);
     flags.historyStarted = 0;
 }
 
+float Channel::getUMonHistory(uint32_t position) const {
+    return g_history[channelIndex].u[position % CHANNEL_HISTORY_SIZE].mean;
+}
+
+float Channel::getIMonHistory(uint32_t position) const {
+    return g_history[channelIndex].i[position % CHANNEL_HISTORY_SIZE].mean;
+}
+
 void Channel::clearCalibrationConf() {
     cal_conf.flags.u_cal_params_exists = 0;
     cal_conf.flags.i_cal_params_exists_range_high = 0;
@@ -741,6 +781,11 @@ bool Channel::isOk() {
 }
 
 void Channel::tick(uint32_t tick_usec) {
+    if (statisticsResetRequested) {
+        doResetStatistics();
+        statisticsResetRequested = false;
+    }
+
     if (!isOk()) {
         return;
     }
@@ -774,12 +819,16 @@ void Channel::tick(uint32_t tick_usec) {
         flags.historyStarted = 1;
         historyLastTick = tick_usec;
         historyPosition = 0;
+        resetHistoryAccumulator(uHistoryAccumulator);
+        resetHistoryAccumulator(iHistoryAccumulator);
+        resetHistoryAccumulator(pHistoryAccumulator);
     } else {
         uint32_t ytViewRateMicroseconds = (int)round(ytViewRate * 1000000L);
         while (tick_usec - historyLastTick >= ytViewRateMicroseconds) {
             uint32_t historyIndex = historyPosition % CHANNEL_HISTORY_SIZE;
-            uHistory[historyIndex] = channel_dispatcher::getUMonLast(*this);
-            iHistory[historyIndex] = channel_dispatcher::getIMonLast(*this);
+            storeHistoryValue(uHistoryAccumulator, channel_dispatcher::getUMonLast(*this), g_history[channelIndex].u[historyIndex]);
+            storeHistoryValue(iHistoryAccumulator, channel_dispatcher::getIMonLast(*this), g_history[channelIndex].i[historyIndex]);
+            storeHistoryValue(pHistoryAccumulator, channel_dispatcher::getUMonLast(*this) * channel_dispatcher::getIMonLast(*this), g_history[channelIndex].p[historyIndex]);
             ++historyPosition;
             historyLastTick += ytViewRateMicroseconds;
         }
@@ -877,11 +926,17 @@ AdcDataType Channel::onAdcData(AdcDataType adcDataType, float value) {
 
         case ADC_DATA_TYPE_U_MON:
             addUMonAdcValue(value);
+            addHistoryValue(uHistoryAccumulator, channel_dispatcher::getUMonLast(*this));
+            statistics.u.add(channel_dispatcher::getUMonLast(*this));
             nextAdcDataType = ADC_DATA_TYPE_I_MON;
             break;
 
         case ADC_DATA_TYPE_I_MON:
             addIMonAdcValue(value);
+            addHistoryValue(iHistoryAccumulator, channel_dispatcher::getIMonLast(*this));
+            // power of each U_MON/I_MON pair, product of the U and I envelopes is not the power envelope
+            addHistoryValue(pHistoryAccumulator, channel_dispatcher::getUMonLast(*this) * channel_dispatcher::getIMonLast(*this));
+            addStatisticsCurrentValue(channel_dispatcher::getIMonLast(*this));
 
             if (isOutputEnabled()) {
                 if (isRemoteProgrammingEnabled()) {
@@ -892,6 +947,7 @@ AdcDataType Channel::onAdcData(AdcDataType adcDataType, float value) {
             } else {
                 u.resetMonValues();
                 i.resetMonValues();
+                statistics.integrating = false;
                 nextAdcDataType = ADC_DATA_TYPE_I_MON_DAC;
             }
 
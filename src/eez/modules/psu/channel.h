@@ -487,18 +487,66 @@ class Channel {
     float getUSetUnbalanced();
     float getISetUnbalanced();
 
+    /// Envelope of all the monitored values received during one YT graph history slot.
+    struct HistoryValue {
+        float min;
+        float max;
+        float mean;
+    };
+
+    struct HistoryAccumulator {
+        float min;
+        float max;
+        float sum;
+        uint32_t count;
+    };
+
     uint32_t getCurrentHistoryValuePosition() {
         return historyPosition;
     }
-    float getUMonHistory(uint32_t position) const {
-        return uHistory[position % CHANNEL_HISTORY_SIZE];
-    }
-    float getIMonHistory(uint32_t position) const {
-        return iHistory[position % CHANNEL_HISTORY_SIZE];
-    }
+    float getUMonHistory(uint32_t position) const;
+    float getIMonHistory(uint32_t position) const;
 
     void resetHistory();
 
+    /// Statistics of one monitored value, updated on every ADC conversion.
+    struct StatisticsValue {
+        float min;
+        float max;
+        double sum;
+        double sumOfSquares;
+        uint32_t count;
+
+        void reset();
+        void add(float value);
+
+        /// Returns NAN if there are no samples yet.
+        float getMin() const;
+        float getMax() const;
+        float getMean() const;
+        float getRms() const;
+    };
+
+    struct Statistics {
+        StatisticsValue u;
+        StatisticsValue i;
+        double ampHours;
+        double wattHours;
+        uint32_t resetTime; // in milliseconds
+        uint32_t lastCurrentSampleTime; // in microseconds
+        bool integrating;
+
+        /// Number of seconds since the last reset.
+        float getDuration() const;
+    };
+
+    Statistics statistics;
+
+    /// Clear min/max/mean/RMS and the charge/energy accumulated since the last reset.
+    /// Statistics are updated by the PSU thread, so the reset is only requested here
+    /// and done by the PSU thread on the next channel tick.
+    void resetStatistics();
+
     TriggerMode getVoltageTriggerMode();
     void setVoltageTriggerMode(TriggerMode mode);
 
@@ -549,13 +597,16 @@ class Channel {
     
     MaxCurrentLimitCause maxCurrentLimitCause;
 
-    float uHistory[CHANNEL_HISTORY_SIZE];
-    float iHistory[CHANNEL_HISTORY_SIZE];
+    // history values are in CHANNEL_HISTORY_BUFFER
+    HistoryAccumulator uHistoryAccumulator;
+    HistoryAccumulator iHistoryAccumulator;
+    HistoryAccumulator pHistoryAccumulator;
     uint32_t historyPosition;
     uint32_t historyLastTick;
 
     int reg_get_ques_isum_bit_mask_for_channel_protection_value(ProtectionValue &cpv);
 
+    static float getHistoryValue(Channel &channel, int rowIndex, int columnIndex, float *max);
     static float getChannel0HistoryValue(int rowIndex, int columnIndex, float *max);
     static float getChannel1HistoryValue(int rowIndex, int columnIndex, float *max);
     static float getChannel2HistoryValue(int rowIndex, int columnIndex, float *max);
@@ -572,6 +623,10 @@ class Channel {
     bool isVoltageCalibrationEnabled();
     bool isCurrentCalibrationEnabled();
 
+    volatile bool statisticsResetRequested;
+    void doResetStatistics();
+    void addStatisticsCurrentValue(float iMon);
+
     void addUMonAdcValue(float value);
     void addIMonAdcValue(float value);
     void addUMonDacAdcValue(float value);
@@ -64,6 +64,9 @@ void tick(uint32_t tickCount) {
             for (unsigned i = 0; i < sizeof(g_variables) / sizeof(DebugVariable *); ++i) {
                 g_variables[i]->tick1secPeriod();
             }
+            for (DebugProbe *probe = DebugProbe::getFirst(); probe; probe = probe->getNext()) {
+                probe->tick1secPeriod();
+            }
             g_previousTickCount1sec = tickCount;
         }
     } else {
@@ -75,6 +78,9 @@ void tick(uint32_t tickCount) {
             for (unsigned i = 0; i < sizeof(g_variables) / sizeof(DebugVariable *); ++i) {
                 g_variables[i]->tick10secPeriod();
             }
+            for (DebugProbe *probe = DebugProbe::getFirst(); probe; probe = probe->getNext()) {
+                probe->tick10secPeriod();
+            }
             g_previousTickCount10sec = tickCount;
         }
     } else {
@@ -24,6 +24,7 @@
 
 using eez::debug::DebugCounterVariable;
 using eez::debug::DebugDurationVariable;
+using eez::debug::DebugProbe;
 using eez::debug::DebugValueVariable;
 using eez::debug::DebugVariable;
 
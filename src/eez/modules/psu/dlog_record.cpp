@@ -22,6 +22,7 @@
 
 #include <math.h>
 
+#include <eez/debug.h>
 #include <eez/index.h>
 #include <eez/scpi/scpi.h>
 
@@ -36,6 +37,12 @@
 
 #include <eez/memory.h>
 
+#include <eez/libs/lz4/lz4.h>
+
+#if defined(EEZ_PLATFORM_STM32)
+#include <eez/platform/stm32/dwt_delay.h>
+#endif
+
 namespace eez {
 
 using namespace scpi;
@@ -92,86 +99,426 @@ static uint32_t g_lastSyncTickCount;
 
 uint32_t g_fileLength;
 
-#define CHUNK_SIZE 4096
+// Data is saved in chunks of the SD card cluster size, clamped to this range.
+// Max. chunk is 1/4 of the buffer, so the PSU task can keep filling the rest of
+// the buffer while the SCPI task writes the previous chunk.
+#define CHUNK_SIZE_MIN 4096
+#define CHUNK_SIZE_MAX (DLOG_RECORD_BUFFER_SIZE / 4)
+
+// Warn when this much of the buffer is waiting to be saved.
+#define WRITER_BEHIND_THRESHOLD (DLOG_RECORD_BUFFER_SIZE / 4 * 3)
+
+static uint32_t g_chunkSize = CHUNK_SIZE_MIN;
 
 static unsigned int g_bufferIndex;
 
-static unsigned int g_lastSavedBufferIndex;
-static unsigned int g_saveUpToBufferIndex;
+static volatile unsigned int g_lastSavedBufferIndex;
+static volatile unsigned int g_saveUpToBufferIndex;
+
+// only one DLOG_FILE_WRITE message is in the SCPI queue at any time
+static volatile bool g_fileWritePending;
+static bool g_writerBehindReported;
+
+FileWriterStatistics g_fileWriterStatistics;
+
+// File stays open for the whole recording, it is closed by the first
+// fileWrite() executed after the recording is finished, or by fileOpen()
+// of the next recording if that fileWrite() is not executed yet.
+// g_file and g_fileIsOpen are used from the SCPI thread (fileWrite) and from the thread
+// which starts the recording (fileOpen), so every access is done under this mutex
+osMutexDef(g_fileMutex);
+static osMutexId(g_fileMutexId);
+
+static File g_file;
+static bool g_fileIsOpen;
+static volatile bool g_syncRequested;
+
+static uint32_t g_filePosition;
+
+// VERSION3 block index and encoding buffers, see dlog_view.h for the file format
+static uint32_t * const g_blockIndexOffsets = (uint32_t *)DLOG_COMPRESS_BUFFER;
+static uint8_t * const g_encodeBuffer = DLOG_COMPRESS_BUFFER + dlog_view::MAX_BLOCK_INDEX_ENTRIES * sizeof(uint32_t);
+static const uint32_t COMPRESSED_BUFFER_SIZE = (LZ4_COMPRESSBOUND(dlog_view::MAX_BLOCK_DATA_SIZE) + 7) & ~7;
+static uint8_t * const g_compressedBuffer = g_encodeBuffer + dlog_view::MAX_BLOCK_DATA_SIZE;
+static void * const g_lz4State = g_compressedBuffer + COMPRESSED_BUFFER_SIZE;
+
+static_assert(dlog_view::MAX_BLOCK_INDEX_ENTRIES * sizeof(uint32_t) + dlog_view::MAX_BLOCK_DATA_SIZE + COMPRESSED_BUFFER_SIZE + LZ4_STREAMSIZE <= DLOG_COMPRESS_BUFFER_SIZE, "DLOG_COMPRESS_BUFFER too small");
+
+static dlog_view::BlockIndex g_blockIndex;
+static bool g_blockIndexSaved;
+
+static void lockFile() {
+    osMutexWait(g_fileMutexId, osWaitForever);
+}
+
+static void unlockFile() {
+    osMutexRelease(g_fileMutexId);
+}
+
+// must be called with the file mutex locked
+static void fileClose() {
+    if (g_fileIsOpen) {
+        g_file.close();
+        g_fileIsOpen = false;
+    }
+}
+
+static size_t writeToFile(const uint8_t *buffer, size_t length) {
+    size_t written = g_file.write(buffer, length);
+    g_filePosition += written;
+    return written;
+}
+
+// write bytes from the DLOG_RECORD_BUFFER ring buffer
+static bool writeRaw(uint32_t fromBufferIndex, uint32_t toBufferIndex, size_t &written) {
+    size_t length = toBufferIndex - fromBufferIndex;
+
+    int i = fromBufferIndex % DLOG_RECORD_BUFFER_SIZE;
+    int j = toBufferIndex % DLOG_RECORD_BUFFER_SIZE;
+
+    size_t n;
+    if (i < j || j == 0) {
+        n = writeToFile(DLOG_RECORD_BUFFER + i, length);
+    } else {
+        n = writeToFile(DLOG_RECORD_BUFFER + i, DLOG_RECORD_BUFFER_SIZE - i) + writeToFile(DLOG_RECORD_BUFFER, j);
+    }
+
+    written += n;
+    return n == length;
+}
+
+static void encodeBlock(uint32_t bufferIndex, uint32_t numRows, uint32_t numColumns) {
+    for (uint32_t columnIndex = 0; columnIndex < numColumns; columnIndex++) {
+        uint8_t *dest = g_encodeBuffer + columnIndex * 4 * numRows;
+        uint32_t previousValue = 0;
+        for (uint32_t rowIndex = 0; rowIndex < numRows; rowIndex++) {
+            uint32_t value;
+            memcpy(&value, DLOG_RECORD_BUFFER + (bufferIndex + (rowIndex * numColumns + columnIndex) * 4) % DLOG_RECORD_BUFFER_SIZE, 4);
+            uint32_t xored = value ^ previousValue;
+            previousValue = value;
+            dest[rowIndex] = xored & 0xFF;
+            dest[numRows + rowIndex] = (xored >> 8) & 0xFF;
+            dest[2 * numRows + rowIndex] = (xored >> 16) & 0xFF;
+            dest[3 * numRows + rowIndex] = xored >> 24;
+        }
+    }
+}
+
+static bool writeCompressedBlock(uint32_t bufferIndex, uint32_t numRows, size_t &written) {
+    uint32_t numColumns = g_recording.parameters.numYAxes;
+    int dataSize = numRows * numColumns * 4;
+
+    encodeBlock(bufferIndex, numRows, numColumns);
+
+    uint8_t encoding = dlog_view::BLOCK_ENCODING_XOR_LZ4;
+    const uint8_t *payload = g_compressedBuffer;
+    int payloadSize = LZ4_compress_fast_extState(g_lz4State, (const char *)g_encodeBuffer, (char *)g_compressedBuffer, dataSize, COMPRESSED_BUFFER_SIZE, 1);
+    if (payloadSize <= 0 || payloadSize >= dataSize) {
+        encoding = dlog_view::BLOCK_ENCODING_XOR;
+        payload = g_encodeBuffer;
+        payloadSize = dataSize;
+    }
+
+    uint8_t header[dlog_view::BLOCK_HEADER_SIZE] = {
+        (uint8_t)(numRows & 0xFF), (uint8_t)(numRows >> 8),
+        encoding,
+        0,
+        (uint8_t)(payloadSize & 0xFF), (uint8_t)((payloadSize >> 8) & 0xFF), (uint8_t)((payloadSize >> 16) & 0xFF), (uint8_t)(payloadSize >> 24)
+    };
+
+    dlog_view::addToBlockIndex(g_blockIndex, g_filePosition);
+
+    size_t n = writeToFile(header, sizeof(header)) + writeToFile(payload, payloadSize);
+    written += n;
+    g_fileLength += n;
+    return n == sizeof(header) + payloadSize;
+}
+
+static bool writeCompressed(uint32_t saveUpToBufferIndex, size_t &written) {
+    // header is not compressed
+    if (g_lastSavedBufferIndex < g_recording.dataOffset) {
+        uint32_t headerEnd = MIN(saveUpToBufferIndex, g_recording.dataOffset);
+        if (!writeRaw(g_lastSavedBufferIndex, headerEnd, written)) {
+            return false;
+        }
+        g_lastSavedBufferIndex = headerEnd;
+    }
+
+    // only the last block can have less then ROWS_PER_BLOCK rows
+    bool isLastBlock = g_state != STATE_EXECUTING && saveUpToBufferIndex == g_bufferIndex;
+
+    uint32_t rowSize = g_recording.parameters.numYAxes * sizeof(float);
+    while (true) {
+        uint32_t numRows = MIN((saveUpToBufferIndex - g_lastSavedBufferIndex) / rowSize, dlog_view::ROWS_PER_BLOCK);
+        if (numRows == 0 || (numRows < dlog_view::ROWS_PER_BLOCK && !isLastBlock)) {
+            break;
+        }
+
+        if (!writeCompressedBlock(g_lastSavedBufferIndex, numRows, written)) {
+            return false;
+        }
+
+        g_lastSavedBufferIndex += numRows * rowSize;
+    }
+
+    return true;
+}
+
+static void writeBlockIndex() {
+    uint32_t numRows = (g_lastSavedBufferIndex - g_recording.dataOffset) / (g_recording.parameters.numYAxes * sizeof(float));
+
+    uint32_t trailer[4] = {
+        g_blockIndex.numEntries,
+        g_blockIndex.stride,
+        numRows,
+        dlog_view::BLOCK_INDEX_MAGIC
+    };
+
+    // file is little endian, same as both platforms
+    size_t length = g_blockIndex.numEntries * sizeof(uint32_t);
+    if (writeToFile((const uint8_t *)g_blockIndex.offsets, length) != length || writeToFile((const uint8_t *)trailer, sizeof(trailer)) != sizeof(trailer)) {
+        event_queue::pushEvent(event_queue::EVENT_ERROR_DLOG_WRITE_ERROR);
+    }
+}
+
+// Writes the rows up to saveUpToBufferIndex, must be called with the file mutex locked.
+static bool writeData(uint32_t saveUpToBufferIndex, size_t &written) {
+    bool result;
+    if (g_recording.version == dlog_view::VERSION3) {
+        result = writeCompressed(saveUpToBufferIndex, written);
+    } else {
+        result = writeRaw(g_lastSavedBufferIndex, saveUpToBufferIndex, written);
+        g_lastSavedBufferIndex = saveUpToBufferIndex;
+    }
+    return result;
+}
+
+// Saves what is left of the previous recording, i.e. the last chunk and the VERSION3
+// block index, and closes its file. Must be called with the file mutex locked.
+static void fileFinish() {
+    if (!g_fileIsOpen) {
+        return;
+    }
+
+    auto saveUpToBufferIndex = g_saveUpToBufferIndex;
+    if (saveUpToBufferIndex != g_lastSavedBufferIndex) {
+        size_t written = 0;
+        if (!writeData(saveUpToBufferIndex, written)) {
+            event_queue::pushEvent(event_queue::EVENT_ERROR_DLOG_WRITE_ERROR);
+            g_lastSavedBufferIndex = saveUpToBufferIndex;
+            g_blockIndexSaved = true;
+        }
+    }
+
+    if (g_recording.version == dlog_view::VERSION3 && !g_blockIndexSaved && g_lastSavedBufferIndex == g_bufferIndex) {
+        writeBlockIndex();
+        g_blockIndexSaved = true;
+    }
+
+    fileClose();
+}
 
 int fileOpen() {
-    File file;
-    if (!file.open(g_parameters.filePath, FILE_OPEN_APPEND | FILE_WRITE)) {
+    // pyramid of the previous recording with the same file path would be shown otherwise
+    dlog_view::deletePyramidFile(g_parameters.filePath);
+
+    lockFile();
+
+    fileFinish();
+
+    if (!g_file.open(g_parameters.filePath, FILE_OPEN_APPEND | FILE_WRITE)) {
+        unlockFile();
         event_queue::pushEvent(event_queue::EVENT_ERROR_DLOG_FILE_OPEN_ERROR);
         // TODO replace with more specific error
         return SCPI_ERROR_MASS_STORAGE_ERROR;
     }
 
-    bool result = file.truncate(0);
-    file.close();
-    if (!result) {
+    if (!g_file.truncate(0)) {
+        g_file.close();
+        unlockFile();
         event_queue::pushEvent(event_queue::EVENT_ERROR_DLOG_TRUNCATE_ERROR);
         // TODO replace with more specific error
         return SCPI_ERROR_MASS_STORAGE_ERROR;
     }
 
+    g_fileIsOpen = true;
+    g_syncRequested = false;
+    g_filePosition = 0;
+
+    // reset under the lock, so fileWrite of the previous recording, if it is still queued,
+    // doesn't write anything into the new file
+    g_bufferIndex = 0;
+    g_lastSavedBufferIndex = 0;
+    g_saveUpToBufferIndex = 0;
+
+    dlog_view::initBlockIndex(g_blockIndex, g_blockIndexOffsets);
+    g_blockIndexSaved = false;
+
+    unlockFile();
+
     return SCPI_RES_OK;
 }
 
+// Flush duration is measured with the DWT cycle counter on STM32, because micros() has
+// only 1 ms resolution there. Single flush is much shorter than the counter wrap around.
+static uint32_t getFlushTimestamp() {
+#if defined(EEZ_PLATFORM_STM32)
+    return *DWT_CYCCNT;
+#else
+    return micros();
+#endif
+}
+
+static uint32_t getFlushDuration(uint32_t startTimestamp) {
+#if defined(EEZ_PLATFORM_STM32)
+    return (*DWT_CYCCNT - startTimestamp) / g_cyclesPerMicrosecond;
+#else
+    return micros() - startTimestamp;
+#endif
+}
+
+DebugProbeDefine(g_fileWriteProbe, "sd:write");
+
 void fileWrite() {
+    g_fileWritePending = false;
+
+    lockFile();
+
+    // read under the lock, fileOpen of the next recording could reset it in the meantime
     auto saveUpToBufferIndex = g_saveUpToBufferIndex;
-    size_t length = saveUpToBufferIndex - g_lastSavedBufferIndex;
-    if (length > 0) {
-        File file;
-        if (!file.open(g_recording.parameters.filePath, FILE_OPEN_APPEND | FILE_WRITE)) {
-            event_queue::pushEvent(event_queue::EVENT_ERROR_DLOG_FILE_REOPEN_ERROR);
-            abort(false);
-            return;
+    if (saveUpToBufferIndex != g_lastSavedBufferIndex) {
+        DebugProbeStart(g_fileWriteProbe);
+        uint32_t start = getFlushTimestamp();
+
+        if (!g_fileIsOpen) {
+            if (!g_file.open(g_recording.parameters.filePath, FILE_OPEN_APPEND | FILE_WRITE)) {
+                unlockFile();
+                event_queue::pushEvent(event_queue::EVENT_ERROR_DLOG_FILE_REOPEN_ERROR);
+                g_lastSavedBufferIndex = saveUpToBufferIndex;
+                g_blockIndexSaved = true;
+                abort(false);
+                return;
+            }
+            g_fileIsOpen = true;
         }
 
-        int i = g_lastSavedBufferIndex % DLOG_RECORD_BUFFER_SIZE;
-        int j = saveUpToBufferIndex % DLOG_RECORD_BUFFER_SIZE;
+        size_t written = 0;
+        bool result = writeData(saveUpToBufferIndex, written);
 
-        size_t written;
-        if (i < j || j == 0) {
-            written = file.write(DLOG_RECORD_BUFFER + i, length);
-        } else {
-            written = file.write(DLOG_RECORD_BUFFER + i, DLOG_RECORD_BUFFER_SIZE - i) + file.write(DLOG_RECORD_BUFFER, j);
+        if (g_syncRequested) {
+            g_syncRequested = false;
+            g_file.sync();
+            g_fileWriterStatistics.numSyncs++;
         }
 
-        g_lastSavedBufferIndex = saveUpToBufferIndex;
+        // abort below flushes and closes the file through fileWrite again
+        unlockFile();
 
-        file.close();
+        uint32_t duration = getFlushDuration(start);
+        DebugProbeFinish(g_fileWriteProbe);
+        g_fileWriterStatistics.bytesWritten += written;
+        g_fileWriterStatistics.numFlushes++;
+        if (duration > g_fileWriterStatistics.maxFlushDuration) {
+            g_fileWriterStatistics.maxFlushDuration = duration;
+        }
 
-        if (written != length) {
+        if (!result) {
             event_queue::pushEvent(event_queue::EVENT_ERROR_DLOG_WRITE_ERROR);
+            g_lastSavedBufferIndex = saveUpToBufferIndex;
+            g_blockIndexSaved = true;
             abort(false);
         }
+    } else {
+        unlockFile();
+    }
+
+    if (g_state != STATE_EXECUTING) {
+        lockFile();
+        if (g_recording.version == dlog_view::VERSION3 && !g_blockIndexSaved && g_lastSavedBufferIndex == g_bufferIndex && g_fileIsOpen) {
+            writeBlockIndex();
+            g_blockIndexSaved = true;
+        }
+        fileClose();
+        unlockFile();
     }
 }
 
 void flushData() {
     if (osThreadGetId() != g_scpiTaskHandle) {
+        if (g_fileWritePending) {
+            // pending write will also save everything up to the new g_saveUpToBufferIndex
+            return;
+        }
+        g_fileWritePending = true;
         osMessagePut(g_scpiMessageQueueId, SCPI_QUEUE_MESSAGE(SCPI_QUEUE_MESSAGE_TARGET_NONE, SCPI_QUEUE_MESSAGE_DLOG_FILE_WRITE, 0), osWaitForever);
     } else {
         fileWrite();
     }
 }
 
+static void checkChunk() {
+    if (g_state == STATE_EXECUTING && (g_bufferIndex - g_saveUpToBufferIndex) >= g_chunkSize) {
+        g_lastSyncTickCount = micros();
+        // save only whole chunks, so every write starts and ends at the cluster boundary
+        g_saveUpToBufferIndex = g_bufferIndex - g_bufferIndex % g_chunkSize;
+        flushData();
+    }
+}
+
 void writeUint8(uint8_t value) {
     *(DLOG_RECORD_BUFFER + (g_bufferIndex % DLOG_RECORD_BUFFER_SIZE)) = value;
 
     g_bufferIndex++;
 
-    if (g_state == STATE_EXECUTING && (g_bufferIndex - g_saveUpToBufferIndex) >= CHUNK_SIZE) {
-        g_lastSyncTickCount = micros();
-        g_saveUpToBufferIndex = g_bufferIndex;
-        flushData();
-    }
+    checkChunk();
 
     ++g_fileLength;
 }
 
+// Copy whole block into the ring buffer (at most two memcpy's if it wraps around)
+// and check for the chunk flush only once. Returns false if the block was dropped.
+static bool writeBlock(const uint8_t *data, uint32_t length) {
+    if (g_state == STATE_EXECUTING) {
+        uint32_t numBytesPending = g_bufferIndex + length - g_lastSavedBufferIndex;
+
+        if (numBytesPending > DLOG_RECORD_BUFFER_SIZE) {
+            // writer fell behind, don't overwrite data not saved yet
+            g_fileWriterStatistics.numOverruns++;
+            return false;
+        }
+
+        if (numBytesPending > g_fileWriterStatistics.bufferHighWaterMark) {
+            g_fileWriterStatistics.bufferHighWaterMark = numBytesPending;
+            if (numBytesPending > WRITER_BEHIND_THRESHOLD && !g_writerBehindReported) {
+                g_writerBehindReported = true;
+                event_queue::pushEvent(event_queue::EVENT_WARNING_DLOG_WRITER_BEHIND);
+            }
+        }
+    }
+
+    uint32_t i = g_bufferIndex % DLOG_RECORD_BUFFER_SIZE;
+    uint32_t n = DLOG_RECORD_BUFFER_SIZE - i;
+    if (length <= n) {
+        memcpy(DLOG_RECORD_BUFFER + i, data, length);
+    } else {
+        memcpy(DLOG_RECORD_BUFFER + i, data, n);
+        memcpy(DLOG_RECORD_BUFFER, data + n, length - n);
+    }
+
+    g_bufferIndex += length;
+    if (g_recording.version != dlog_view::VERSION3) {
+        g_fileLength += length;
+    }
+
+    checkChunk();
+
+    return true;
+}
+
+static bool writeRow(const float *row, int numColumns) {
+    return writeBlock((const uint8_t *)row, numColumns * sizeof(float));
+}
+
 void writeUint16(uint16_t value) {
     writeUint8(value & 0xFF);
     writeUint8((value >> 8) & 0xFF);
@@ -363,6 +710,67 @@ float getValue(int rowIndex, int columnIndex, float *max) {
     return value;
 }
 
+// Index of the oldest row not (being) overwritten in the ring buffer. Writer can be in the
+// middle of the next row, so bytes up to bufferIndex + rowSize are treated as overwritten.
+static uint32_t getOldestRowIndex(uint32_t bufferIndex, uint32_t rowSize) {
+    uint32_t dataEnd = bufferIndex - g_recording.dataOffset + rowSize;
+    if (dataEnd <= DLOG_RECORD_BUFFER_SIZE) {
+        return 0;
+    }
+    return (dataEnd - DLOG_RECORD_BUFFER_SIZE + rowSize - 1) / rowSize;
+}
+
+void readRows(uint32_t fromRowIndex, uint32_t maxRows, float *rows, uint32_t &firstRowIndex, uint32_t &numRows, uint32_t &numDroppedRows) {
+    firstRowIndex = fromRowIndex;
+    numRows = 0;
+    numDroppedRows = 0;
+
+    // header of the new recording is written while initiated
+    if (g_state == STATE_INITIATED) {
+        return;
+    }
+
+    uint32_t rowSize = g_recording.parameters.numYAxes * sizeof(float);
+
+    // g_bufferIndex is updated by the PSU task
+    uint32_t bufferIndex = *(volatile unsigned int *)&g_bufferIndex;
+    if (rowSize == 0 || bufferIndex < g_recording.dataOffset) {
+        return;
+    }
+
+    uint32_t numRowsWritten = (bufferIndex - g_recording.dataOffset) / rowSize;
+
+    firstRowIndex = MAX(fromRowIndex, getOldestRowIndex(bufferIndex, rowSize));
+    if (firstRowIndex > numRowsWritten) {
+        firstRowIndex = numRowsWritten;
+    }
+    numRows = MIN(numRowsWritten - firstRowIndex, maxRows);
+
+    uint32_t length = numRows * rowSize;
+    uint32_t i = (g_recording.dataOffset + firstRowIndex * rowSize) % DLOG_RECORD_BUFFER_SIZE;
+    uint32_t n = DLOG_RECORD_BUFFER_SIZE - i;
+    if (length <= n) {
+        memcpy(rows, DLOG_RECORD_BUFFER + i, length);
+    } else {
+        memcpy(rows, DLOG_RECORD_BUFFER + i, n);
+        memcpy((uint8_t *)rows + n, DLOG_RECORD_BUFFER, length - n);
+    }
+
+    // recorder could overwrite the oldest rows while we were copying them
+    bufferIndex = *(volatile unsigned int *)&g_bufferIndex;
+    uint32_t oldestRowIndex = getOldestRowIndex(bufferIndex, rowSize);
+    if (oldestRowIndex > firstRowIndex) {
+        uint32_t numOverwrittenRows = MIN(oldestRowIndex - firstRowIndex, numRows);
+        numRows -= numOverwrittenRows;
+        memmove(rows, (uint8_t *)rows + numOverwrittenRows * rowSize, numRows * rowSize);
+        firstRowIndex += numOverwrittenRows;
+    }
+
+    if (firstRowIndex > fromRowIndex) {
+        numDroppedRows = firstRowIndex - fromRowIndex;
+    }
+}
+
 void log(uint32_t tickCount);
 
 int startImmediately() {
@@ -378,9 +786,17 @@ int startImmediately() {
         return err;
     }
 
-    g_bufferIndex = 0;
-    g_lastSavedBufferIndex = 0;
-    g_saveUpToBufferIndex = 0;
+    memset(&g_fileWriterStatistics, 0, sizeof(g_fileWriterStatistics));
+    g_writerBehindReported = false;
+    g_fileWritePending = false;
+
+    g_chunkSize = sd_card::getClusterSize();
+    if (g_chunkSize < CHUNK_SIZE_MIN) {
+        g_chunkSize = CHUNK_SIZE_MIN;
+    } else if (g_chunkSize > CHUNK_SIZE_MAX) {
+        g_chunkSize = CHUNK_SIZE_MAX;
+    }
+
     g_lastSyncTickCount = micros();
     g_fileLength = 0;
     g_lastTickCount = micros();
@@ -406,10 +822,12 @@ int startImmediately() {
 
     g_recording.getValue = getValue;
 
+    g_recording.version = g_recording.parameters.compress ? dlog_view::VERSION3 : dlog_view::VERSION2;
+
     // header
     writeUint32(dlog_view::MAGIC1);
     writeUint32(dlog_view::MAGIC2);
-    writeUint16(dlog_view::VERSION2);
+    writeUint16(g_recording.version);
     writeUint16(g_recording.parameters.numYAxes);
     uint32_t savedBufferIndex = g_bufferIndex;
     writeUint32(0);
@@ -487,7 +905,20 @@ int startImmediately() {
     return SCPI_RES_OK;
 }
 
+#if defined(EEZ_PLATFORM_SIMULATOR)
+// benchmark borrows DLOG_RECORD_BUFFER, recording started by the trigger waits until it is finished
+static volatile bool g_isBenchmarkRunning;
+static volatile bool g_isTriggerPending;
+#endif
+
 void triggerGenerated() {
+#if defined(EEZ_PLATFORM_SIMULATOR)
+    if (g_isBenchmarkRunning) {
+        g_isTriggerPending = true;
+        return;
+    }
+#endif
+
     int err = startImmediately();
     if (err != SCPI_RES_OK) {
         generateError(err);
@@ -509,6 +940,10 @@ void toggle() {
     }
 }
 
+void init() {
+    g_fileMutexId = osMutexCreate(osMutex(g_fileMutex));
+}
+
 void resetParameters() {
     memset(&g_parameters, 0, sizeof(g_parameters));
 
@@ -522,9 +957,11 @@ void finishLogging(bool flush) {
 
 	if (flush) {
         g_saveUpToBufferIndex = g_bufferIndex;
-        flushData();
 	}
 
+    // flush remaining data (if requested) and close the file
+    flushData();
+
     reset();
 }
 
@@ -536,6 +973,69 @@ void abort(bool flush) {
     }
 }
 
+// Stop recording if some rows were lost, rather than leave the file with the gap in time axis.
+static bool checkOverrun() {
+    if (g_fileWriterStatistics.numOverruns > 0) {
+        event_queue::pushEvent(event_queue::EVENT_ERROR_DLOG_BUFFER_OVERRUN);
+        finishLogging(true);
+        return true;
+    }
+    return false;
+}
+
+static int fillRow(float *row) {
+    int numColumns = 0;
+
+    for (int i = 0; i < CH_NUM; ++i) {
+        Channel &channel = Channel::get(i);
+
+        float uMon = 0;
+        float iMon = 0;
+
+        if (g_recording.parameters.logVoltage[i]) {
+            uMon = channel_dispatcher::getUMonLast(channel);
+            row[numColumns++] = uMon;
+        }
+
+        if (g_recording.parameters.logCurrent[i]) {
+            iMon = channel_dispatcher::getIMonLast(channel);
+            row[numColumns++] = iMon;
+        }
+
+        if (g_recording.parameters.logPower[i]) {
+            if (!g_recording.parameters.logVoltage[i]) {
+                uMon = channel_dispatcher::getUMonLast(channel);
+            }
+            if (!g_recording.parameters.logCurrent[i]) {
+                iMon = channel_dispatcher::getIMonLast(channel);
+            }
+            row[numColumns++] = uMon * iMon;
+        }
+    }
+
+    return numColumns;
+}
+
+#if !defined(EEZ_PLATFORM_SIMULATOR)
+static int fillRowWithNans(float *row) {
+    int numColumns = 0;
+
+    for (int i = 0; i < CH_NUM; ++i) {
+        if (g_recording.parameters.logVoltage[i]) {
+            row[numColumns++] = NAN;
+        }
+        if (g_recording.parameters.logCurrent[i]) {
+            row[numColumns++] = NAN;
+        }
+        if (g_recording.parameters.logPower[i]) {
+            row[numColumns++] = NAN;
+        }
+    }
+
+    return numColumns;
+}
+#endif
+
 void log(uint32_t tickCount) {
     g_micros += tickCount - g_lastTickCount;
     g_lastTickCount = tickCount;
@@ -558,82 +1058,28 @@ void log(uint32_t tickCount) {
                 break;
             }
 
+            float row[dlog_view::MAX_NUM_OF_Y_AXES];
 #if defined(EEZ_PLATFORM_SIMULATOR)
-            for (int i = 0; i < CH_NUM; ++i) {
-                Channel &channel = Channel::get(i);
-
-                float uMon = 0;
-                float iMon = 0;
-
-                if (g_recording.parameters.logVoltage[i]) {
-                    uMon = channel_dispatcher::getUMonLast(channel);
-                    writeFloat(uMon);
-                }
-
-                if (g_recording.parameters.logCurrent[i]) {
-                    iMon = channel_dispatcher::getIMonLast(channel);
-                    writeFloat(iMon);
-                }
-
-                if (g_recording.parameters.logPower[i]) {
-                    if (!g_recording.parameters.logVoltage[i]) {
-                        uMon = channel_dispatcher::getUMonLast(channel);
-                    }
-                    if (!g_recording.parameters.logCurrent[i]) {
-                        iMon = channel_dispatcher::getIMonLast(channel);
-                    }
-                    writeFloat(uMon * iMon);
-                }
-            }
-
-            ++g_recording.size;
+            int numColumns = fillRow(row);
 #else
             // we missed a sample, write NAN's
-            for (int i = 0; i < CH_NUM; ++i) {
-                if (g_recording.parameters.logVoltage[i]) {
-                    writeFloat(NAN);
-                }
-                if (g_recording.parameters.logCurrent[i]) {
-                    writeFloat(NAN);
-                }
-                if (g_recording.parameters.logPower[i]) {
-                    writeFloat(NAN);
-                }
-            }
-
-            ++g_recording.size;
+            int numColumns = fillRowWithNans(row);
 #endif
+            // rows dropped on overrun are not counted, so size matches the file
+            if (writeRow(row, numColumns)) {
+                ++g_recording.size;
+            }
         }
 
         // write sample
-        for (int i = 0; i < CH_NUM; ++i) {
-            Channel &channel = Channel::get(i);
-
-            float uMon = 0;
-            float iMon = 0;
-
-            if (g_recording.parameters.logVoltage[i]) {
-                uMon = channel_dispatcher::getUMonLast(channel);
-                writeFloat(uMon);
-            }
-
-            if (g_recording.parameters.logCurrent[i]) {
-                iMon = channel_dispatcher::getIMonLast(channel);
-                writeFloat(iMon);
-            }
+        float row[dlog_view::MAX_NUM_OF_Y_AXES];
+        if (writeRow(row, fillRow(row))) {
+            ++g_recording.size;
+        }
 
-            if (g_recording.parameters.logPower[i]) {
-                if (!g_recording.parameters.logVoltage[i]) {
-                    uMon = channel_dispatcher::getUMonLast(channel);
-                }
-                if (!g_recording.parameters.logCurrent[i]) {
-                    iMon = channel_dispatcher::getIMonLast(channel);
-                }
-                writeFloat(uMon * iMon);
-            }
+        if (checkOverrun()) {
+            return;
         }
-        
-        ++g_recording.size;
 
         if (g_nextTime > g_recording.parameters.time) {
             finishLogging(true);
@@ -642,6 +1088,7 @@ void log(uint32_t tickCount) {
             if (diff > CONF_DLOG_SYNC_FILE_TIME * 1000000L) {
                 g_lastSyncTickCount = tickCount;
                 g_saveUpToBufferIndex = g_bufferIndex;
+                g_syncRequested = true;
                 flushData();
             }
         }
@@ -649,10 +1096,10 @@ void log(uint32_t tickCount) {
 }
 
 void log(float *values) {
-    for (int yAxisIndex = 0; yAxisIndex < dlog_record::g_recording.parameters.numYAxes; yAxisIndex++) {
-        writeFloat(values[yAxisIndex]);
+    if (writeRow(values, g_recording.parameters.numYAxes)) {
+        ++g_recording.size;
     }
-    ++g_recording.size;
+    checkOverrun();
 }
 
 void tick(uint32_t tickCount) {
@@ -666,6 +1113,64 @@ void reset() {
     resetParameters();
 }
 
+#if defined(EEZ_PLATFORM_SIMULATOR)
+
+int benchmark(uint32_t numRows, float &byteWriterRowsPerSecond, float &rowWriterRowsPerSecond) {
+    g_isTriggerPending = false;
+    g_isBenchmarkRunning = true;
+
+    if (!isIdle()) {
+        g_isBenchmarkRunning = false;
+        return SCPI_ERROR_CANNOT_CHANGE_TRANSIENT_TRIGGER;
+    }
+
+    float row[dlog_view::MAX_NUM_OF_Y_AXES];
+    for (int i = 0; i < dlog_view::MAX_NUM_OF_Y_AXES; i++) {
+        row[i] = 1.0f + i / 1000.0f;
+    }
+
+    // the last recording is still read from DLOG_RECORD_BUFFER (live view, readRows),
+    // so preserve the buffer contents and the write position across the benchmark
+    memcpy(DLOG_BENCHMARK_BUFFER, DLOG_RECORD_BUFFER, DLOG_RECORD_BUFFER_SIZE);
+
+    auto savedBufferIndex = g_bufferIndex;
+    auto savedFileLength = g_fileLength;
+
+    g_bufferIndex = 0;
+    uint32_t start = micros();
+    for (uint32_t i = 0; i < numRows; i++) {
+        for (int j = 0; j < dlog_view::MAX_NUM_OF_Y_AXES; j++) {
+            writeFloat(row[j]);
+        }
+    }
+    uint32_t byteWriterDuration = micros() - start;
+
+    g_bufferIndex = 0;
+    start = micros();
+    for (uint32_t i = 0; i < numRows; i++) {
+        writeRow(row, dlog_view::MAX_NUM_OF_Y_AXES);
+    }
+    uint32_t rowWriterDuration = micros() - start;
+
+    g_bufferIndex = savedBufferIndex;
+    g_fileLength = savedFileLength;
+
+    memcpy(DLOG_RECORD_BUFFER, DLOG_BENCHMARK_BUFFER, DLOG_RECORD_BUFFER_SIZE);
+
+    g_isBenchmarkRunning = false;
+    if (g_isTriggerPending) {
+        g_isTriggerPending = false;
+        triggerGenerated();
+    }
+
+    byteWriterRowsPerSecond = numRows * 1E6f / MAX(byteWriterDuration, 1);
+    rowWriterRowsPerSecond = numRows * 1E6f / MAX(rowWriterDuration, 1);
+
+    return SCPI_RES_OK;
+}
+
+#endif
+
 const char *getLatestFilePath() {
     return g_recording.parameters.filePath[0] != 0 ? g_recording.parameters.filePath : nullptr;
 }
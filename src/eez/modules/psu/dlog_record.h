@@ -45,11 +45,24 @@ extern double g_currentTime;
 
 extern uint32_t g_fileLength;
 
+struct FileWriterStatistics {
+    uint32_t bytesWritten;
+    uint32_t numFlushes;
+    uint32_t numSyncs;
+    uint32_t maxFlushDuration; // in microseconds
+    uint32_t bufferHighWaterMark; // max. number of bytes waiting in DLOG_RECORD_BUFFER to be saved
+    uint32_t numOverruns; // number of rows that didn't fit into DLOG_RECORD_BUFFER
+};
+
+extern FileWriterStatistics g_fileWriterStatistics;
+
 extern dlog_view::Parameters g_parameters;
 extern dlog_view::Parameters g_guiParameters;
 
 extern dlog_view::Recording g_recording;
 
+void init();
+
 State getState();
 int checkDlogParameters(dlog_view::Parameters &parameters, bool doNotCheckFilePath, bool forTraceUsage);
 bool isIdle();
@@ -72,6 +85,16 @@ void fileWrite();
 
 const char *getLatestFilePath();
 
+// Copies up to maxRows rows, starting from fromRowIndex, which are still in DLOG_RECORD_BUFFER.
+// Rows already overwritten by the recorder are skipped: firstRowIndex is then greater than
+// fromRowIndex and numDroppedRows tells how many rows client missed.
+void readRows(uint32_t fromRowIndex, uint32_t maxRows, float *rows, uint32_t &firstRowIndex, uint32_t &numRows, uint32_t &numDroppedRows);
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+// Measures rows/sec of the byte-at-a-time writer vs. the row writer, recorder must be idle.
+int benchmark(uint32_t numRows, float &byteWriterRowsPerSecond, float &rowWriterRowsPerSecond);
+#endif
+
 } // namespace dlog_record
 } // namespace psu
 } // namespace eez
@@ -31,6 +31,8 @@
 #include <eez/modules/psu/channel_dispatcher.h>
 #include <eez/modules/psu/dlog_view.h>
 #include <eez/modules/psu/dlog_record.h>
+#include <eez/modules/psu/list_program.h>
+#include <eez/modules/psu/sd_card.h>
 #include <eez/modules/psu/scpi/psu.h>
 #include <eez/modules/psu/serial_psu.h>
 #if OPTION_ETHERNET
@@ -43,6 +45,8 @@
 
 #include <eez/memory.h>
 
+#include <eez/libs/lz4/lz4.h>
+
 namespace eez {
 
 using namespace scpi;
@@ -58,10 +62,14 @@ bool g_showLabels = false;
 char g_filePath[MAX_PATH_LENGTH + 1];
 Recording g_recording;
 
+// Cache block is identified by (scale, block index) and it is valid only
+// for the cache epoch in which it was allocated, see invalidateAllBlocks.
 struct CacheBlock {
-    unsigned valid: 1;
+    uint32_t epoch;
+    float scale;
+    uint32_t blockIndex;
     uint32_t loadedValues;
-    uint32_t startAddress;
+    uint32_t lastUsed;
 };
 
 struct BlockElement {
@@ -69,16 +77,65 @@ struct BlockElement {
     float max;
 };
 
+// VERSION3 block index and decoding buffers, FILE_VIEW_BUFFER is not used because it is
+// also used by the JPEG decoder
+static const uint32_t BLOCK_INDEX_SIZE = MAX_BLOCK_INDEX_ENTRIES * sizeof(uint32_t);
+static const uint32_t COMPRESSED_BLOCK_BUFFER_SIZE = (LZ4_COMPRESSBOUND(MAX_BLOCK_DATA_SIZE) + 3) & ~3;
+static const uint32_t DECODE_BUFFER_SIZE = BLOCK_INDEX_SIZE + 2 * MAX_BLOCK_DATA_SIZE + COMPRESSED_BLOCK_BUFFER_SIZE;
+
+static_assert(DECODE_BUFFER_SIZE <= DLOG_DECODE_BUFFER_SIZE, "DLOG_DECODE_BUFFER too small");
+
+static uint32_t * const g_blockIndexOffsets = (uint32_t *)DLOG_DECODE_BUFFER;
+static float * const g_decodedRows = (float *)(DLOG_DECODE_BUFFER + BLOCK_INDEX_SIZE);
+static uint8_t * const g_encodedBlock = DLOG_DECODE_BUFFER + BLOCK_INDEX_SIZE + MAX_BLOCK_DATA_SIZE;
+static uint8_t * const g_compressedBlock = DLOG_DECODE_BUFFER + BLOCK_INDEX_SIZE + 2 * MAX_BLOCK_DATA_SIZE;
+
+static BlockIndex g_blockIndex;
+static uint32_t g_decodedBlockIndex;
+static uint32_t g_decodedBlockNumRows;
+
+// Min/max pyramid: level 0 entry is min/max of PYRAMID_FACTOR_MIN rows, every
+// next level entry is min/max of PYRAMID_FACTOR_STEP entries of the previous level.
+// Levels with less then VIEW_WIDTH entries are not needed.
+static const uint32_t PYRAMID_MAGIC = 0x584D4D44; // "DMMX"
+static const uint16_t PYRAMID_VERSION = 2;
+static const uint32_t PYRAMID_FACTOR_MIN = 16;
+static const uint32_t PYRAMID_FACTOR_STEP = 4;
+static const uint32_t PYRAMID_MAX_LEVELS = 14;
+static const uint32_t PYRAMID_WRITE_BUFFER_ENTRIES = 16;
+static const uint32_t PYRAMID_READ_ROWS = 256;
+
+struct PyramidHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t numYAxes;
+    uint32_t sourceFileSize;
+    uint32_t sourceSignature;
+    uint32_t numSamples;
+    uint32_t numLevels;
+    uint32_t levelOffsets[PYRAMID_MAX_LEVELS];
+};
+
+static PyramidHeader g_pyramid;
+static bool g_pyramidValid;
+
 static const uint32_t NUM_ELEMENTS_PER_BLOCKS = 480 * MAX_NUM_OF_Y_VALUES;
 static const uint32_t BLOCK_SIZE = NUM_ELEMENTS_PER_BLOCKS * sizeof(BlockElement);
 static const uint32_t NUM_BLOCKS = FILE_VIEW_BUFFER_SIZE / (BLOCK_SIZE + sizeof(CacheBlock));
 
 CacheBlock *g_cacheBlocks = (CacheBlock *)FILE_VIEW_BUFFER;
 
-static bool g_isLoading;
-static bool g_interruptLoading;
-static uint32_t g_blockIndexToLoad;
-static float g_loadScale;
+// number of blocks to prefetch ahead in the panning direction
+static const int NUM_PREFETCH_BLOCKS = 2;
+
+static uint32_t g_cacheEpoch = 1;
+static uint32_t g_cacheLastUsedCounter;
+static uint32_t g_lastCacheSlot;
+static int g_panDirection = 1;
+
+static volatile bool g_isLoading;
+static volatile bool g_interruptLoading;
+static uint32_t g_cacheSlotToLoad;
 static bool g_refreshed;
 static bool g_wasExecuting;
 
@@ -122,23 +179,734 @@ float readFloat(uint8_t *buffer, uint32_t &offset) {
     return *((float *)&value);
 }
 
-BlockElement *getCacheBlock(unsigned blockIndex) {
-    return (BlockElement *)(FILE_VIEW_BUFFER + NUM_BLOCKS * sizeof(CacheBlock) + blockIndex * BLOCK_SIZE);
+void initBlockIndex(BlockIndex &blockIndex, uint32_t *offsets) {
+    blockIndex.offsets = offsets;
+    blockIndex.numEntries = 0;
+    blockIndex.stride = 1;
+    blockIndex.numBlocks = 0;
+}
+
+// Index keeps offset of every stride-th block. When it is full, every other entry
+// is dropped and stride is doubled, so the index size is bounded for any file length.
+void addToBlockIndex(BlockIndex &blockIndex, uint32_t blockOffset) {
+    if (blockIndex.numBlocks % blockIndex.stride == 0) {
+        if (blockIndex.numEntries == MAX_BLOCK_INDEX_ENTRIES) {
+            for (uint32_t i = 0; i < MAX_BLOCK_INDEX_ENTRIES / 2; i++) {
+                blockIndex.offsets[i] = blockIndex.offsets[2 * i];
+            }
+            blockIndex.numEntries = MAX_BLOCK_INDEX_ENTRIES / 2;
+            blockIndex.stride *= 2;
+        }
+
+        if (blockIndex.numBlocks % blockIndex.stride == 0) {
+            blockIndex.offsets[blockIndex.numEntries++] = blockOffset;
+        }
+    }
+
+    blockIndex.numBlocks++;
+}
+
+static bool readBlockHeader(File &file, uint32_t &numRows, uint8_t &encoding, uint32_t &payloadSize) {
+    uint8_t header[BLOCK_HEADER_SIZE];
+    if (file.read(header, BLOCK_HEADER_SIZE) != BLOCK_HEADER_SIZE) {
+        return false;
+    }
+
+    uint32_t offset = 0;
+    numRows = readUint16(header, offset);
+    encoding = readUint8(header, offset);
+    readUint8(header, offset); // reserved
+    payloadSize = readUint32(header, offset);
+
+    return numRows > 0 && numRows <= ROWS_PER_BLOCK && payloadSize <= COMPRESSED_BLOCK_BUFFER_SIZE;
+}
+
+// Used when block index is missing at the end of file, i.e. recording was interrupted.
+static bool buildBlockIndex(File &file, uint32_t &numRows) {
+    initBlockIndex(g_blockIndex, g_blockIndexOffsets);
+    numRows = 0;
+
+    uint32_t fileSize = file.size();
+    uint32_t blockOffset = g_recording.dataOffset;
+    while (blockOffset + BLOCK_HEADER_SIZE <= fileSize) {
+        uint32_t blockNumRows;
+        uint8_t encoding;
+        uint32_t payloadSize;
+        if (!file.seek(blockOffset) || !readBlockHeader(file, blockNumRows, encoding, payloadSize)) {
+            break;
+        }
+
+        if (blockOffset + BLOCK_HEADER_SIZE + payloadSize > fileSize) {
+            // last block is incomplete
+            break;
+        }
+
+        addToBlockIndex(g_blockIndex, blockOffset);
+        numRows += blockNumRows;
+
+        blockOffset += BLOCK_HEADER_SIZE + payloadSize;
+    }
+
+    return g_blockIndex.numBlocks > 0;
+}
+
+static bool readBlockIndex(File &file, uint32_t &numRows) {
+    uint32_t fileSize = file.size();
+    if (fileSize < g_recording.dataOffset + BLOCK_INDEX_TRAILER_SIZE) {
+        return false;
+    }
+
+    uint8_t trailer[BLOCK_INDEX_TRAILER_SIZE];
+    if (!file.seek(fileSize - BLOCK_INDEX_TRAILER_SIZE) || file.read(trailer, BLOCK_INDEX_TRAILER_SIZE) != BLOCK_INDEX_TRAILER_SIZE) {
+        return false;
+    }
+
+    uint32_t offset = 0;
+    uint32_t numEntries = readUint32(trailer, offset);
+    uint32_t stride = readUint32(trailer, offset);
+    numRows = readUint32(trailer, offset);
+    uint32_t magic = readUint32(trailer, offset);
+
+    if (magic != BLOCK_INDEX_MAGIC || numEntries == 0 || numEntries > MAX_BLOCK_INDEX_ENTRIES || stride == 0) {
+        return false;
+    }
+
+    uint32_t indexSize = numEntries * sizeof(uint32_t);
+    if (fileSize < g_recording.dataOffset + indexSize + BLOCK_INDEX_TRAILER_SIZE) {
+        return false;
+    }
+
+    if (!file.seek(fileSize - BLOCK_INDEX_TRAILER_SIZE - indexSize) || file.read(g_blockIndexOffsets, indexSize) != (int)indexSize) {
+        return false;
+    }
+
+    g_blockIndex.offsets = g_blockIndexOffsets;
+    g_blockIndex.numEntries = numEntries;
+    g_blockIndex.stride = stride;
+    g_blockIndex.numBlocks = (numRows + ROWS_PER_BLOCK - 1) / ROWS_PER_BLOCK;
+
+    return true;
+}
+
+static void decodeBlock(const uint8_t *src, uint32_t numRows, uint32_t numColumns) {
+    uint32_t *dest = (uint32_t *)g_decodedRows;
+    for (uint32_t columnIndex = 0; columnIndex < numColumns; columnIndex++) {
+        const uint8_t *columnData = src + columnIndex * 4 * numRows;
+        uint32_t value = 0;
+        for (uint32_t rowIndex = 0; rowIndex < numRows; rowIndex++) {
+            value ^= columnData[rowIndex] |
+                (columnData[numRows + rowIndex] << 8) |
+                (columnData[2 * numRows + rowIndex] << 16) |
+                (columnData[3 * numRows + rowIndex] << 24);
+            dest[rowIndex * numColumns + columnIndex] = value;
+        }
+    }
+}
+
+static bool loadCompressedBlock(File &file, uint32_t blockIndex) {
+    if (blockIndex == g_decodedBlockIndex) {
+        return true;
+    }
+
+    g_decodedBlockIndex = (uint32_t)-1;
+
+    uint32_t indexEntry = blockIndex / g_blockIndex.stride;
+    if (indexEntry >= g_blockIndex.numEntries) {
+        return false;
+    }
+
+    uint32_t blockOffset = g_blockIndex.offsets[indexEntry];
+
+    uint32_t numRows;
+    uint8_t encoding;
+    uint32_t payloadSize;
+
+    // skip blocks between the indexed one and the one we need
+    for (uint32_t i = indexEntry * g_blockIndex.stride; ; i++) {
+        if (!file.seek(blockOffset) || !readBlockHeader(file, numRows, encoding, payloadSize)) {
+            return false;
+        }
+
+        if (i == blockIndex) {
+            break;
+        }
+
+        blockOffset += BLOCK_HEADER_SIZE + payloadSize;
+    }
+
+    uint32_t dataSize = numRows * g_recording.parameters.numYAxes * sizeof(float);
+
+    if (encoding == BLOCK_ENCODING_XOR) {
+        if (payloadSize != dataSize || file.read(g_encodedBlock, dataSize) != (int)dataSize) {
+            return false;
+        }
+    } else if (encoding == BLOCK_ENCODING_XOR_LZ4) {
+        if (file.read(g_compressedBlock, payloadSize) != (int)payloadSize) {
+            return false;
+        }
+        if (LZ4_decompress_safe((const char *)g_compressedBlock, (char *)g_encodedBlock, payloadSize, MAX_BLOCK_DATA_SIZE) != (int)dataSize) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    decodeBlock(g_encodedBlock, numRows, g_recording.parameters.numYAxes);
+
+    g_decodedBlockIndex = blockIndex;
+    g_decodedBlockNumRows = numRows;
+
+    return true;
+}
+
+static bool readRows(File &file, uint32_t rowIndex, uint32_t numRows, float *values) {
+    uint32_t rowSize = g_recording.parameters.numYAxes * sizeof(float);
+
+    if (g_recording.version != VERSION3) {
+        if (!file.seek(g_recording.dataOffset + rowIndex * rowSize)) {
+            return false;
+        }
+        return file.read(values, numRows * rowSize) == (int)(numRows * rowSize);
+    }
+
+    while (numRows > 0) {
+        if (!loadCompressedBlock(file, rowIndex / ROWS_PER_BLOCK)) {
+            return false;
+        }
+
+        uint32_t rowIndexInBlock = rowIndex % ROWS_PER_BLOCK;
+        if (rowIndexInBlock >= g_decodedBlockNumRows) {
+            return false;
+        }
+
+        uint32_t n = MIN(numRows, g_decodedBlockNumRows - rowIndexInBlock);
+        memcpy(values, g_decodedRows + rowIndexInBlock * g_recording.parameters.numYAxes, n * rowSize);
+
+        values += n * g_recording.parameters.numYAxes;
+        rowIndex += n;
+        numRows -= n;
+    }
+
+    return true;
+}
+
+static bool getPyramidFilePath(const char *filePath, char *pyramidFilePath) {
+    if (strlen(filePath) + strlen(PYRAMID_FILE_EXT) > MAX_PATH_LENGTH) {
+        return false;
+    }
+    strcpy(pyramidFilePath, filePath);
+    strcat(pyramidFilePath, PYRAMID_FILE_EXT);
+    return true;
+}
+
+void deletePyramidFile(const char *filePath) {
+    char pyramidFilePath[MAX_PATH_LENGTH + 1];
+    if (getPyramidFilePath(filePath, pyramidFilePath) && sd_card::exists(pyramidFilePath, nullptr)) {
+        sd_card::deleteFile(pyramidFilePath, nullptr);
+    }
+}
+
+static uint32_t getPyramidFactor(uint32_t level) {
+    return PYRAMID_FACTOR_MIN << (2 * level);
+}
+
+static uint32_t getPyramidNumEntries(uint32_t level) {
+    uint32_t factor = getPyramidFactor(level);
+    return (g_pyramid.numSamples + factor - 1) / factor;
+}
+
+static uint32_t getPyramidEntrySize() {
+    return g_pyramid.numYAxes * sizeof(BlockElement);
+}
+
+struct PyramidLevelBuilder {
+    uint32_t count;
+    uint32_t numEntriesSaved;
+    uint32_t numEntriesBuffered;
+    BlockElement *writeBuffer;
+    BlockElement entry[MAX_NUM_OF_Y_AXES];
+};
+
+static bool flushPyramidLevel(File &pyramidFile, uint32_t level, PyramidLevelBuilder &builder) {
+    if (builder.numEntriesBuffered == 0) {
+        return true;
+    }
+
+    uint32_t entrySize = getPyramidEntrySize();
+    uint32_t length = builder.numEntriesBuffered * entrySize;
+    if (!pyramidFile.seek(g_pyramid.levelOffsets[level] + builder.numEntriesSaved * entrySize) ||
+        pyramidFile.write((const uint8_t *)builder.writeBuffer, length) != length) {
+        return false;
+    }
+
+    builder.numEntriesSaved += builder.numEntriesBuffered;
+    builder.numEntriesBuffered = 0;
+    return true;
+}
+
+static void mergeIntoPyramidEntry(PyramidLevelBuilder &builder, const BlockElement *elements) {
+    for (uint32_t k = 0; k < g_pyramid.numYAxes; k++) {
+        if (builder.count == 0) {
+            builder.entry[k] = elements[k];
+        } else {
+            if (elements[k].min < builder.entry[k].min) {
+                builder.entry[k].min = elements[k].min;
+            }
+            if (elements[k].max > builder.entry[k].max) {
+                builder.entry[k].max = elements[k].max;
+            }
+        }
+    }
+    builder.count++;
+}
+
+// Completed entry of the level goes into the write buffer and into the next level entry.
+static bool emitPyramidEntry(File &pyramidFile, PyramidLevelBuilder *builders, uint32_t level) {
+    PyramidLevelBuilder &builder = builders[level];
+
+    memcpy(builder.writeBuffer + builder.numEntriesBuffered * g_pyramid.numYAxes, builder.entry, getPyramidEntrySize());
+    builder.numEntriesBuffered++;
+    builder.count = 0;
+
+    if (level + 1 < g_pyramid.numLevels) {
+        PyramidLevelBuilder &nextBuilder = builders[level + 1];
+        mergeIntoPyramidEntry(nextBuilder, builder.entry);
+        if (nextBuilder.count == PYRAMID_FACTOR_STEP && !emitPyramidEntry(pyramidFile, builders, level + 1)) {
+            return false;
+        }
+    }
+
+    if (builder.numEntriesBuffered == PYRAMID_WRITE_BUFFER_ENTRIES) {
+        return flushPyramidLevel(pyramidFile, level, builder);
+    }
+
+    return true;
+}
+
+// Pyramid is built by the SCPI task from the idle part of its loop, at most PYRAMID_BUILD_STEP_ROWS
+// rows and PYRAMID_BUILD_STEP_MAX_DURATION ms at a time, so the dlog file writes and the list stream
+// refills, which are also done by the SCPI task, are not delayed too much. Until it is finished,
+// the view is loaded from the raw samples.
+static const uint32_t PYRAMID_BUILD_STEP_ROWS = 4 * PYRAMID_READ_ROWS;
+static const uint32_t PYRAMID_BUILD_STEP_MAX_DURATION = 5;
+
+static bool g_isPyramidBuilding;
+// set by the SCPI task when the build is finished, GUI task then starts using the pyramid
+static volatile bool g_pyramidReady;
+static uint32_t g_pyramidBuildRowIndex;
+static char g_pyramidSourceFilePath[MAX_PATH_LENGTH + 1];
+static char g_pyramidFilePath[MAX_PATH_LENGTH + 1];
+static File g_pyramidFile;
+static PyramidLevelBuilder g_pyramidBuilders[PYRAMID_MAX_LEVELS];
+
+// cache blocks in FILE_VIEW_BUFFER are used by the view during the build, so it has its own memory
+static float * const g_pyramidRows = (float *)DLOG_PYRAMID_BUFFER;
+static BlockElement * const g_pyramidWriteBuffers = (BlockElement *)(DLOG_PYRAMID_BUFFER + PYRAMID_READ_ROWS * MAX_NUM_OF_Y_AXES * sizeof(float));
+
+static_assert(PYRAMID_READ_ROWS * MAX_NUM_OF_Y_AXES * sizeof(float) + PYRAMID_MAX_LEVELS * PYRAMID_WRITE_BUFFER_ENTRIES * MAX_NUM_OF_Y_AXES * sizeof(BlockElement) <= DLOG_PYRAMID_BUFFER_SIZE,
+    "DLOG_PYRAMID_BUFFER is too small");
+
+static void startPyramidBuild(const char *pyramidFilePath) {
+    if (!g_pyramidFile.open(pyramidFilePath, FILE_CREATE_ALWAYS | FILE_WRITE)) {
+        return;
+    }
+
+    strcpy(g_pyramidSourceFilePath, g_filePath);
+    strcpy(g_pyramidFilePath, pyramidFilePath);
+
+    uint32_t numYAxes = g_pyramid.numYAxes;
+    uint32_t entrySize = getPyramidEntrySize();
+
+    uint32_t offset = sizeof(PyramidHeader);
+    for (uint32_t level = 0; level < g_pyramid.numLevels; level++) {
+        g_pyramid.levelOffsets[level] = offset;
+        offset += getPyramidNumEntries(level) * entrySize;
+    }
+
+    for (uint32_t level = 0; level < g_pyramid.numLevels; level++) {
+        g_pyramidBuilders[level].count = 0;
+        g_pyramidBuilders[level].numEntriesSaved = 0;
+        g_pyramidBuilders[level].numEntriesBuffered = 0;
+        g_pyramidBuilders[level].writeBuffer = g_pyramidWriteBuffers + level * PYRAMID_WRITE_BUFFER_ENTRIES * numYAxes;
+    }
+
+    g_pyramidBuildRowIndex = 0;
+    g_isPyramidBuilding = true;
+}
+
+static void abortPyramidBuild() {
+    if (g_isPyramidBuilding) {
+        g_isPyramidBuilding = false;
+        g_pyramidFile.close();
+        sd_card::deleteFile(g_pyramidFilePath, nullptr);
+    }
+}
+
+static bool finishPyramidBuild() {
+    // last, incomplete entries
+    for (uint32_t level = 0; level < g_pyramid.numLevels; level++) {
+        if (g_pyramidBuilders[level].count > 0 && !emitPyramidEntry(g_pyramidFile, g_pyramidBuilders, level)) {
+            return false;
+        }
+        if (!flushPyramidLevel(g_pyramidFile, level, g_pyramidBuilders[level])) {
+            return false;
+        }
+    }
+
+    // header is written last, so interrupted build is not recognized as valid
+    g_pyramid.magic = PYRAMID_MAGIC;
+    return g_pyramidFile.seek(0) && g_pyramidFile.write((const uint8_t *)&g_pyramid, sizeof(PyramidHeader)) == sizeof(PyramidHeader);
+}
+
+void buildPyramidStep() {
+    if (!g_isPyramidBuilding) {
+        return;
+    }
+
+    if (g_state != STATE_READY || strcmp(g_filePath, g_pyramidSourceFilePath) != 0) {
+        // other file is being opened
+        abortPyramidBuild();
+        return;
+    }
+
+    if (!dlog_record::isIdle() || list::isStreamActive()) {
+        // continue when recording or list execution from the file is finished
+        return;
+    }
+
+    uint32_t numYAxes = g_pyramid.numYAxes;
+    bool result = true;
+
+    File file;
+    if (file.open(g_pyramidSourceFilePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        BlockElement elements[MAX_NUM_OF_Y_AXES];
+        uint32_t startTime = millis();
+        uint32_t endRowIndex = MIN(g_pyramidBuildRowIndex + PYRAMID_BUILD_STEP_ROWS, g_pyramid.numSamples);
+        while (result && g_pyramidBuildRowIndex < endRowIndex && millis() - startTime < PYRAMID_BUILD_STEP_MAX_DURATION) {
+            uint32_t numRows = MIN(PYRAMID_READ_ROWS, endRowIndex - g_pyramidBuildRowIndex);
+            if (!readRows(file, g_pyramidBuildRowIndex, numRows, g_pyramidRows)) {
+                result = false;
+                break;
+            }
+
+            for (uint32_t j = 0; j < numRows; j++) {
+                for (uint32_t k = 0; k < numYAxes; k++) {
+                    elements[k].min = elements[k].max = g_pyramidRows[j * numYAxes + k];
+                }
+
+                mergeIntoPyramidEntry(g_pyramidBuilders[0], elements);
+                if (g_pyramidBuilders[0].count == PYRAMID_FACTOR_MIN && !emitPyramidEntry(g_pyramidFile, g_pyramidBuilders, 0)) {
+                    result = false;
+                    break;
+                }
+            }
+
+            g_pyramidBuildRowIndex += numRows;
+        }
+        file.close();
+    } else {
+        result = false;
+    }
+
+    if (!result) {
+        abortPyramidBuild();
+        return;
+    }
+
+    if (g_pyramidBuildRowIndex < g_pyramid.numSamples) {
+        // continue in the next step
+        return;
+    }
+
+    result = finishPyramidBuild();
+
+    g_isPyramidBuilding = false;
+    g_pyramidFile.close();
+
+    if (!result) {
+        sd_card::deleteFile(g_pyramidFilePath, nullptr);
+        return;
+    }
+
+    // cache is owned by the GUI task, see stateManagment
+    g_pyramidReady = true;
+}
+
+// Pyramid is valid only for the file with the same size and the same bytes at the beginning
+// (header with the recording start time) and at the end, so it is rebuilt when file with the
+// same name and size is recorded again or copied over.
+static uint32_t getSourceSignature(File &file, uint32_t fileSize) {
+    static const uint32_t SIGNATURE_DATA_SIZE = 256;
+    uint8_t buffer[SIGNATURE_DATA_SIZE];
+
+    uint32_t hash = 2166136261UL;
+
+    for (int part = 0; part < 2; part++) {
+        uint32_t length = MIN(fileSize, SIGNATURE_DATA_SIZE);
+        uint32_t position = part == 0 ? 0 : fileSize - length;
+        if (!file.seek(position) || file.read(buffer, length) != (int)length) {
+            return 0;
+        }
+        for (uint32_t i = 0; i < length; i++) {
+            hash = (hash ^ buffer[i]) * 16777619UL;
+        }
+    }
+
+    return hash;
+}
+
+static void openPyramid(File &file, uint32_t numSamples) {
+    g_pyramidValid = false;
+
+    uint32_t numLevels = 0;
+    while (numLevels < PYRAMID_MAX_LEVELS && numSamples / getPyramidFactor(numLevels) >= (uint32_t)VIEW_WIDTH) {
+        numLevels++;
+    }
+    if (numLevels == 0) {
+        // file is small enough to be loaded from the raw samples
+        return;
+    }
+
+    char pyramidFilePath[MAX_PATH_LENGTH + 1];
+    if (!getPyramidFilePath(g_filePath, pyramidFilePath)) {
+        return;
+    }
+
+    uint32_t sourceFileSize = file.size();
+    uint32_t sourceSignature = getSourceSignature(file, sourceFileSize);
+
+    File pyramidFile;
+    if (pyramidFile.open(pyramidFilePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        bool valid = pyramidFile.read(&g_pyramid, sizeof(PyramidHeader)) == sizeof(PyramidHeader) &&
+            g_pyramid.magic == PYRAMID_MAGIC &&
+            g_pyramid.version == PYRAMID_VERSION &&
+            g_pyramid.numYAxes == g_recording.parameters.numYAxes &&
+            g_pyramid.sourceFileSize == sourceFileSize &&
+            g_pyramid.sourceSignature == sourceSignature &&
+            g_pyramid.numSamples == numSamples &&
+            g_pyramid.numLevels == numLevels;
+        pyramidFile.close();
+
+        if (valid) {
+            g_pyramidValid = true;
+            return;
+        }
+    }
+
+    memset(&g_pyramid, 0, sizeof(PyramidHeader));
+    g_pyramid.version = PYRAMID_VERSION;
+    g_pyramid.numYAxes = g_recording.parameters.numYAxes;
+    g_pyramid.sourceFileSize = sourceFileSize;
+    g_pyramid.sourceSignature = sourceSignature;
+    g_pyramid.numSamples = numSamples;
+    g_pyramid.numLevels = numLevels;
+
+    startPyramidBuild(pyramidFilePath);
+}
+
+// Coarsest level with factor not greater then number of samples per pixel column,
+// so at most PYRAMID_FACTOR_STEP + 1 entries are read per column.
+static int getPyramidLevel(uint32_t numSamplesPerValue) {
+    if (!g_pyramidValid) {
+        return -1;
+    }
+
+    int level = -1;
+    while (level + 1 < (int)g_pyramid.numLevels && getPyramidFactor(level + 1) <= numSamplesPerValue) {
+        level++;
+    }
+    return level;
+}
+
+static bool loadFromPyramid(File &pyramidFile, int level, uint32_t rowIndex, uint32_t numSamplesPerValue, BlockElement *blockElements, uint32_t numElementsPerRow, BlockElement *entries, uint32_t maxEntries, uint32_t &bytesRead) {
+    uint32_t factor = getPyramidFactor(level);
+    uint32_t numEntries = getPyramidNumEntries(level);
+    uint32_t entrySize = getPyramidEntrySize();
+
+    uint32_t firstEntry = rowIndex / factor;
+    if (firstEntry >= numEntries) {
+        return false;
+    }
+    uint32_t lastEntry = MIN((rowIndex + numSamplesPerValue - 1) / factor, numEntries - 1);
+
+    if (!pyramidFile.seek(g_pyramid.levelOffsets[level] + firstEntry * entrySize)) {
+        return false;
+    }
+
+    for (uint32_t entryIndex = firstEntry; entryIndex <= lastEntry; ) {
+        uint32_t n = MIN(lastEntry + 1 - entryIndex, maxEntries);
+        if (pyramidFile.read(entries, n * entrySize) != (int)(n * entrySize)) {
+            return false;
+        }
+        bytesRead += n * entrySize;
+
+        for (uint32_t j = 0; j < n; j++) {
+            for (uint32_t k = 0; k < numElementsPerRow; k++) {
+                const BlockElement &entry = entries[j * g_pyramid.numYAxes + k];
+                if (entryIndex == firstEntry && j == 0) {
+                    blockElements[k] = entry;
+                } else {
+                    if (entry.min < blockElements[k].min) {
+                        blockElements[k].min = entry.min;
+                    }
+                    if (entry.max > blockElements[k].max) {
+                        blockElements[k].max = entry.max;
+                    }
+                }
+            }
+        }
+
+        entryIndex += n;
+    }
+
+    return true;
+}
+
+BlockElement *getCacheBlock(unsigned cacheSlot) {
+    return (BlockElement *)(FILE_VIEW_BUFFER + NUM_BLOCKS * sizeof(CacheBlock) + cacheSlot * BLOCK_SIZE);
+}
+
+static bool isCacheSlotValid(uint32_t cacheSlot, uint32_t blockIndex, float scale) {
+    CacheBlock &cacheBlock = g_cacheBlocks[cacheSlot];
+    return cacheBlock.epoch == g_cacheEpoch && cacheBlock.blockIndex == blockIndex && cacheBlock.scale == scale;
+}
+
+static int findCacheSlot(uint32_t blockIndex, float scale) {
+    if (isCacheSlotValid(g_lastCacheSlot, blockIndex, scale)) {
+        return g_lastCacheSlot;
+    }
+
+    for (uint32_t cacheSlot = 0; cacheSlot < NUM_BLOCKS; cacheSlot++) {
+        if (isCacheSlotValid(cacheSlot, blockIndex, scale)) {
+            return cacheSlot;
+        }
+    }
+
+    return -1;
+}
+
+// Returns cache slot for the block, if block is not in the cache the least recently used slot is taken.
+// Slot currently being loaded is never taken, so there is no need to wait for the loader.
+static uint32_t getCacheSlot(uint32_t blockIndex, float scale) {
+    int cacheSlot = findCacheSlot(blockIndex, scale);
+
+    if (cacheSlot == -1) {
+        for (uint32_t i = 0; i < NUM_BLOCKS; i++) {
+            if (g_isLoading && i == g_cacheSlotToLoad) {
+                continue;
+            }
+
+            if (g_cacheBlocks[i].epoch != g_cacheEpoch) {
+                cacheSlot = i;
+                break;
+            }
+
+            if (cacheSlot == -1 || g_cacheBlocks[i].lastUsed < g_cacheBlocks[cacheSlot].lastUsed) {
+                cacheSlot = i;
+            }
+        }
+
+        BlockElement *blockElements = getCacheBlock(cacheSlot);
+        for (unsigned i = 0; i < NUM_ELEMENTS_PER_BLOCKS; i++) {
+            blockElements[i].min = NAN;
+            blockElements[i].max = NAN;
+        }
+
+        CacheBlock &cacheBlock = g_cacheBlocks[cacheSlot];
+        cacheBlock.epoch = g_cacheEpoch;
+        cacheBlock.scale = scale;
+        cacheBlock.blockIndex = blockIndex;
+        cacheBlock.loadedValues = 0;
+        cacheBlock.lastUsed = ++g_cacheLastUsedCounter;
+    } else if (cacheSlot != (int)g_lastCacheSlot) {
+        g_cacheBlocks[cacheSlot].lastUsed = ++g_cacheLastUsedCounter;
+    }
+
+    g_lastCacheSlot = cacheSlot;
+
+    return cacheSlot;
+}
+
+static void loadCacheSlot(uint32_t cacheSlot) {
+    g_isLoading = true;
+    g_interruptLoading = false;
+    g_cacheSlotToLoad = cacheSlot;
+
+    osMessagePut(g_scpiMessageQueueId, SCPI_QUEUE_MESSAGE(SCPI_QUEUE_MESSAGE_TARGET_NONE, SCPI_QUEUE_MESSAGE_DLOG_LOAD_BLOCK, 0), osWaitForever);
+}
+
+static float getLoadScale() {
+    return g_recording.xAxisDiv / g_recording.xAxisDivMin;
 }
 
 unsigned getNumElementsPerRow() {
     return MIN(g_recording.parameters.numYAxes, MAX_NUM_OF_Y_VALUES);
 }
 
+// Blocks from the previous epoch are treated as free slots, block that is
+// currently loading is abandoned by the loader at the next check.
 void invalidateAllBlocks() {
     g_interruptLoading = true;
+    g_cacheEpoch++;
+}
+
+float getValue(int rowIndex, int columnIndex, float *max);
+
+// Called once per GUI frame. Loader is interrupted if it is busy with the block
+// that is not visible while some visible block is not loaded yet. When all the
+// visible blocks are loaded, next blocks in the panning direction are prefetched.
+static void manageLoading() {
+    if (g_state != STATE_READY || getRecording().getValue != getValue || g_recording.size == 0) {
+        return;
+    }
+
+    float scale = getLoadScale();
+    uint32_t elementsPerRow = getNumElementsPerRow();
+
+    uint32_t position = getPosition(g_recording);
+    uint32_t firstVisibleBlockIndex = position * elementsPerRow / NUM_ELEMENTS_PER_BLOCKS;
+    uint32_t lastVisibleBlockIndex = (position + g_recording.pageSize - 1) * elementsPerRow / NUM_ELEMENTS_PER_BLOCKS;
+    uint32_t lastBlockIndex = (g_recording.size - 1) * elementsPerRow / NUM_ELEMENTS_PER_BLOCKS;
+    if (lastVisibleBlockIndex > lastBlockIndex) {
+        lastVisibleBlockIndex = lastBlockIndex;
+    }
 
-    while (g_isLoading) {
-        osDelay(1);
+    bool visibleBlocksLoaded = true;
+    for (uint32_t blockIndex = firstVisibleBlockIndex; blockIndex <= lastVisibleBlockIndex; blockIndex++) {
+        int cacheSlot = findCacheSlot(blockIndex, scale);
+        if (cacheSlot == -1 || g_cacheBlocks[cacheSlot].loadedValues < NUM_ELEMENTS_PER_BLOCKS) {
+            visibleBlocksLoaded = false;
+            break;
+        }
+    }
+
+    if (g_isLoading) {
+        if (!visibleBlocksLoaded) {
+            CacheBlock &cacheBlock = g_cacheBlocks[g_cacheSlotToLoad];
+            if (cacheBlock.epoch != g_cacheEpoch || cacheBlock.scale != scale ||
+                cacheBlock.blockIndex < firstVisibleBlockIndex || cacheBlock.blockIndex > lastVisibleBlockIndex) {
+                g_interruptLoading = true;
+            }
+        }
+        return;
+    }
+
+    if (!visibleBlocksLoaded) {
+        // visible blocks are loaded from getValue
+        return;
     }
 
-    for (unsigned blockIndex = 0; blockIndex < NUM_BLOCKS; blockIndex++) {
-        g_cacheBlocks[blockIndex].valid = false;
+    for (int i = 1; i <= NUM_PREFETCH_BLOCKS; i++) {
+        int blockIndex = g_panDirection > 0 ? (int)lastVisibleBlockIndex + i : (int)firstVisibleBlockIndex - i;
+        if (blockIndex < 0 || blockIndex > (int)lastBlockIndex) {
+            break;
+        }
+
+        int cacheSlot = findCacheSlot(blockIndex, scale);
+        if (cacheSlot == -1 || g_cacheBlocks[cacheSlot].loadedValues < NUM_ELEMENTS_PER_BLOCKS) {
+            loadCacheSlot(cacheSlot == -1 ? getCacheSlot(blockIndex, scale) : cacheSlot);
+            break;
+        }
     }
 }
 
@@ -146,26 +914,54 @@ void loadBlock() {
     static const int NUM_VALUES_ROWS = 16;
     float values[18 * NUM_VALUES_ROWS];
 
-    auto numSamplesPerValue = (unsigned)round(g_loadScale);
+    uint32_t cacheSlot = g_cacheSlotToLoad;
+    CacheBlock &cacheBlock = g_cacheBlocks[cacheSlot];
+    float loadScale = cacheBlock.scale;
+
+    auto numSamplesPerValue = (unsigned)round(loadScale);
     if (numSamplesPerValue > 0) {
         File file;
         if (file.open(g_filePath, FILE_OPEN_EXISTING | FILE_READ)) {
             auto numElementsPerRow = getNumElementsPerRow();
 
-            BlockElement *blockElements = getCacheBlock(g_blockIndexToLoad);
+            BlockElement *blockElements = getCacheBlock(cacheSlot);
 
             uint32_t totalBytesRead = 0;
 
-            uint32_t i = g_cacheBlocks[g_blockIndexToLoad].loadedValues;
+            File pyramidFile;
+            int pyramidLevel = getPyramidLevel(numSamplesPerValue);
+            if (pyramidLevel != -1) {
+                char pyramidFilePath[MAX_PATH_LENGTH + 1];
+                if (!getPyramidFilePath(g_filePath, pyramidFilePath) || !pyramidFile.open(pyramidFilePath, FILE_OPEN_EXISTING | FILE_READ)) {
+                    pyramidLevel = -1;
+                }
+            }
+
+            uint32_t i = cacheBlock.loadedValues;
             while (i < NUM_ELEMENTS_PER_BLOCKS) {
-                auto offset = (uint32_t)roundf((g_blockIndexToLoad * NUM_ELEMENTS_PER_BLOCKS + i) / numElementsPerRow * g_loadScale * g_recording.parameters.numYAxes);
+                if (g_interruptLoading) {
+                    // keep what is loaded so far, loading will continue when block is needed again
+                    goto closeFile;
+                }
 
-                offset = g_recording.parameters.numYAxes *((offset + g_recording.parameters.numYAxes - 1) / g_recording.parameters.numYAxes);
+                auto offset = (uint32_t)roundf((cacheBlock.blockIndex * NUM_ELEMENTS_PER_BLOCKS + i) / numElementsPerRow * loadScale * g_recording.parameters.numYAxes);
 
-                size_t filePosition = g_recording.dataOffset + offset * sizeof(float);
-                if (!file.seek(filePosition)) {
-                    i = NUM_ELEMENTS_PER_BLOCKS;
-                    goto closeFile;
+                uint32_t rowIndex = (offset + g_recording.parameters.numYAxes - 1) / g_recording.parameters.numYAxes;
+
+                if (pyramidLevel != -1) {
+                    if (!loadFromPyramid(pyramidFile, pyramidLevel, rowIndex, numSamplesPerValue, blockElements + i, numElementsPerRow,
+                        (BlockElement *)values, sizeof(values) / getPyramidEntrySize(), totalBytesRead)) {
+                        i = NUM_ELEMENTS_PER_BLOCKS;
+                        goto closeFile;
+                    }
+
+                    i += numElementsPerRow;
+                    g_refreshed = true;
+
+                    if (totalBytesRead > NUM_ELEMENTS_PER_BLOCKS * sizeof(BlockElement)) {
+                        break;
+                    }
+                    continue;
                 }
 
                 unsigned iStart = i;
@@ -177,19 +973,18 @@ void loadBlock() {
 
                     if (valuesRow == 0) {
                         if (g_interruptLoading) {
-                            i = NUM_ELEMENTS_PER_BLOCKS;
+                            i = iStart;
                             goto closeFile;
                         }
 
                         // read up to NUM_VALUES_ROWS
-                        uint32_t bytesToRead = MIN(NUM_VALUES_ROWS, numSamplesPerValue - j) * g_recording.parameters.numYAxes * sizeof(float);
-                        uint32_t bytesRead = file.read(values, bytesToRead);
-                        if (bytesToRead != bytesRead) {
+                        uint32_t rowsToRead = MIN(NUM_VALUES_ROWS, numSamplesPerValue - j);
+                        if (!readRows(file, rowIndex + j, rowsToRead, values)) {
                             i = NUM_ELEMENTS_PER_BLOCKS;
                             goto closeFile;
                         }
 
-                        totalBytesRead += bytesRead;
+                        totalBytesRead += rowsToRead * g_recording.parameters.numYAxes * sizeof(float);
                     }
 
                     unsigned valuesOffset = valuesRow * g_recording.parameters.numYAxes;
@@ -219,8 +1014,11 @@ void loadBlock() {
             }
 
         closeFile:
-            g_cacheBlocks[g_blockIndexToLoad].loadedValues = i;
+            cacheBlock.loadedValues = i;
             file.close();
+            if (pyramidLevel != -1) {
+                pyramidFile.close();
+            }
         }
     }
 
@@ -235,40 +1033,35 @@ void stateManagment() {
     }
     g_wasExecuting = isExecuting;
 
+    if (g_pyramidReady) {
+        g_pyramidReady = false;
+        if (g_state == STATE_READY) {
+            g_pyramidValid = true;
+            // blocks loaded from the raw samples so far are reloaded from the pyramid
+            invalidateAllBlocks();
+            g_refreshed = true;
+        }
+    }
+
     if (g_refreshed) {
         ++g_recording.refreshCounter;
         g_refreshed = false;
     }
+
+    manageLoading();
 }
 
 float getValue(int rowIndex, int columnIndex, float *max) {
     uint32_t blockElementAddress = (rowIndex * getNumElementsPerRow() + columnIndex) * sizeof(BlockElement);
 
     uint32_t blockIndex = blockElementAddress / BLOCK_SIZE;
-    uint32_t blockStartAddress = blockIndex * BLOCK_SIZE;
-
-    blockIndex %= NUM_BLOCKS;
-
-    BlockElement *blockElements = getCacheBlock(blockIndex);
-
-    if (!(g_cacheBlocks[blockIndex].valid && g_cacheBlocks[blockIndex].startAddress == blockStartAddress)) {
-        for (unsigned i = 0; i < NUM_ELEMENTS_PER_BLOCKS; i++) {
-            blockElements[i].min = NAN;
-            blockElements[i].max = NAN;
-        }
 
-        g_cacheBlocks[blockIndex].valid = 1;
-        g_cacheBlocks[blockIndex].loadedValues = 0;
-        g_cacheBlocks[blockIndex].startAddress = blockStartAddress;
-    }
+    uint32_t cacheSlot = getCacheSlot(blockIndex, getLoadScale());
 
-    if (!g_isLoading && g_cacheBlocks[blockIndex].loadedValues < NUM_ELEMENTS_PER_BLOCKS) {
-        g_isLoading = true;
-        g_interruptLoading = false;
-        g_blockIndexToLoad = blockIndex;
-        g_loadScale = g_recording.xAxisDiv / g_recording.xAxisDivMin;
+    BlockElement *blockElements = getCacheBlock(cacheSlot);
 
-        osMessagePut(g_scpiMessageQueueId, SCPI_QUEUE_MESSAGE(SCPI_QUEUE_MESSAGE_TARGET_NONE, SCPI_QUEUE_MESSAGE_DLOG_LOAD_BLOCK, 0), osWaitForever);
+    if (!g_isLoading && g_cacheBlocks[cacheSlot].loadedValues < NUM_ELEMENTS_PER_BLOCKS) {
+        loadCacheSlot(cacheSlot);
     }
 
     uint32_t blockElementIndex = (blockElementAddress % BLOCK_SIZE) / sizeof(BlockElement);
@@ -322,6 +1115,7 @@ void changeXAxisOffset(Recording &recording, float xAxisOffset) {
     if (&dlog_view::g_recording == &recording) {
         float newXAxisOffset = xAxisOffset;
         if (newXAxisOffset != recording.xAxisOffset) {
+            g_panDirection = newXAxisOffset > recording.xAxisOffset ? 1 : -1;
             recording.xAxisOffset = newXAxisOffset;
             adjustXAxisOffset(recording);
         }
@@ -343,8 +1137,6 @@ void changeXAxisDiv(Recording &recording, float xAxisDiv) {
         }
         
         adjustXAxisOffset(recording);
-
-        invalidateAllBlocks();
     }
 }
 
@@ -569,6 +1361,10 @@ void openFile(const char *filePath) {
         return;
     }
 
+    abortPyramidBuild();
+    g_pyramidReady = false;
+    g_pyramidValid = false;
+
     File file;
     if (file.open(g_filePath, FILE_OPEN_EXISTING | FILE_READ)) {
         uint8_t * buffer = FILE_VIEW_BUFFER;
@@ -580,9 +1376,11 @@ void openFile(const char *filePath) {
             uint32_t magic2 = readUint32(buffer, offset);
             uint16_t version = readUint16(buffer, offset);
 
-            if (magic1 == MAGIC1 && magic2 == MAGIC2 && (version == VERSION1 || version == VERSION2)) {
+            if (magic1 == MAGIC1 && magic2 == MAGIC2 && (version == VERSION1 || version == VERSION2 || version == VERSION3)) {
                 bool invalidHeader = false;
 
+                g_recording.version = version;
+
                 if (version == VERSION1) {
                     g_recording.dataOffset = DLOG_VERSION1_HEADER_SIZE;
 
@@ -714,12 +1512,26 @@ void openFile(const char *filePath) {
 					g_recording.parameters.time = g_recording.parameters.xAxis.range.max - g_recording.parameters.xAxis.range.min;
                 }
 
+                uint32_t numSamples = 0;
                 if (!invalidHeader) {
+                    if (version == VERSION3) {
+                        g_decodedBlockIndex = (uint32_t)-1;
+                        if (!readBlockIndex(file, numSamples) && !buildBlockIndex(file, numSamples)) {
+                            invalidHeader = true;
+                        }
+                    } else {
+                        numSamples = (file.size() - g_recording.dataOffset) / (g_recording.parameters.numYAxes * sizeof(float));
+                    }
+                }
+
+                if (!invalidHeader) {
+                    openPyramid(file, numSamples);
+
                     initDlogValues(g_recording);
 
                     g_recording.pageSize = VIEW_WIDTH;
 
-                    g_recording.numSamples = (file.size() - g_recording.dataOffset) / (g_recording.parameters.numYAxes * sizeof(float));
+                    g_recording.numSamples = numSamples;
                     g_recording.xAxisDivMin = g_recording.pageSize * g_recording.parameters.period / dlog_view::NUM_HORZ_DIVISIONS;
                     g_recording.xAxisDivMax = MAX(g_recording.numSamples, g_recording.pageSize) * g_recording.parameters.period / dlog_view::NUM_HORZ_DIVISIONS;
 
@@ -51,6 +51,36 @@ OFFSET    TYPE    WIDTH    DESCRIPTION
 24              U32     4        Start time, timestamp
 
 28+(n*N+m)*4    Float   4        n-th row and m-th column value, N - number of columns
+
+VERSION2 has the same first 12 bytes, followed by:
+
+12              U32     4        Data offset, header is followed by the list of meta fields
+                                 (see Fields enum), each field is: U16 length, U8 id, data
+
+DataOffset+(n*N+m)*4  Float   4  n-th row and m-th column value, N - number of columns
+
+VERSION3 has the same header as VERSION2, but data is stored in blocks of up to
+ROWS_PER_BLOCK rows, every block except the last one has exactly ROWS_PER_BLOCK rows:
+
+0               U16     2        Number of rows in this block
+2               U8      1        Encoding: BLOCK_ENCODING_XOR or BLOCK_ENCODING_XOR_LZ4
+3               U8      1        Reserved
+4               U32     4        Payload size
+8               ...              Payload
+
+Every value is XOR-ed with the previous value in the same column (first row of the
+block is XOR-ed with 0, so each block can be decoded on its own) and then stored
+column by column, split into byte planes: byte 0 of all rows, byte 1 of all rows, ...
+With BLOCK_ENCODING_XOR_LZ4 this is additionally compressed with LZ4.
+
+Blocks are followed by the block index, which is missing if recording was
+interrupted (in that case viewer will build the index by walking the blocks):
+
+0               U32     4*K      File offset of every S-th block
+4*K             U32     4        K - number of index entries
+4*K+4           U32     4        S - index stride (in blocks)
+4*K+8           U32     4        Total number of rows
+4*K+12          U32     4        BLOCK_INDEX_MAGIC
 */
 
 namespace eez {
@@ -61,6 +91,7 @@ static const uint32_t MAGIC1 = 0x2D5A4545;
 static const uint32_t MAGIC2 = 0x474F4C44;
 static const uint16_t VERSION1 = 1;
 static const uint16_t VERSION2 = 2;
+static const uint16_t VERSION3 = 3;
 static const uint32_t DLOG_VERSION1_HEADER_SIZE = 28;
 
 static const int VIEW_WIDTH = 480;
@@ -73,6 +104,15 @@ static const int MAX_NUM_OF_Y_AXES = CH_MAX * 3;
 
 static const int MAX_COMMENT_LENGTH = 128;
 
+static const uint32_t ROWS_PER_BLOCK = 256;
+static const uint32_t MAX_BLOCK_DATA_SIZE = ROWS_PER_BLOCK * MAX_NUM_OF_Y_AXES * sizeof(float);
+static const uint32_t BLOCK_HEADER_SIZE = 8;
+static const uint8_t BLOCK_ENCODING_XOR = 0;
+static const uint8_t BLOCK_ENCODING_XOR_LZ4 = 1;
+static const uint32_t MAX_BLOCK_INDEX_ENTRIES = 4096;
+static const uint32_t BLOCK_INDEX_MAGIC = 0x58444942;
+static const uint32_t BLOCK_INDEX_TRAILER_SIZE = 16;
+
 enum State {
     STATE_STARTING,
     STATE_LOADING,
@@ -167,6 +207,7 @@ struct Parameters {
     float period;
     float time;
     trigger::Source triggerSource;
+    bool compress; // write VERSION3 file
 };
 
 struct DlogValueParams {
@@ -199,10 +240,18 @@ struct Recording {
     float xAxisDivMax;
 
     uint32_t dataOffset;
+    uint16_t version;
 
     uint8_t selectedVisibleValueIndex;
 };
 
+struct BlockIndex {
+    uint32_t *offsets;
+    uint32_t numEntries;
+    uint32_t stride;
+    uint32_t numBlocks;
+};
+
 extern bool g_showLatest;
 extern bool g_showLegend;
 extern bool g_showLabels;
@@ -210,6 +259,15 @@ extern bool g_showLabels;
 // open dlog file for viewing
 void openFile(const char *filePath);
 
+// min/max summary of the dlog file is cached in the file with this extension appended
+#define PYRAMID_FILE_EXT ".mmx"
+
+void deletePyramidFile(const char *filePath);
+
+// Builds next part of the pyramid for the opened file, if it is being built,
+// this is called from the thread that owns SD card when it is idle.
+void buildPyramidStep();
+
 extern State getState();
 
 // this is called from the thread that owns SD card
@@ -242,6 +300,10 @@ void scaleToFit(Recording &recording);
 
 float roundValue(float value);
 
+// VERSION3 data blocks
+void initBlockIndex(BlockIndex &blockIndex, uint32_t *offsets);
+void addToBlockIndex(BlockIndex &blockIndex, uint32_t blockOffset);
+
 void uploadFile();
 
 } // namespace dlog_view
@@ -117,6 +117,7 @@ static const int EVENT_TYPE_ERROR = 3;
 	EVENT_ERROR(DLOG_TRUNCATE_ERROR, 111, "DLOG truncate error")                                   \
 	EVENT_ERROR(DLOG_FILE_REOPEN_ERROR, 112, "DLOG file reopen error")                             \
 	EVENT_ERROR(DLOG_WRITE_ERROR, 113, "DLOG write")                                               \
+	EVENT_ERROR(DLOG_BUFFER_OVERRUN, 114, "DLOG writer fell behind")                               \
     EVENT_ERROR(SAVE_DEV_CONF_BLOCK_0, 120, "Failed to save configuration block 0")                \
     EVENT_ERROR(SAVE_DEV_CONF_BLOCK_1, 121, "Failed to save configuration block 1")                \
     EVENT_ERROR(SAVE_DEV_CONF_BLOCK_2, 122, "Failed to save configuration block 2")                \
@@ -155,6 +156,7 @@ static const int EVENT_TYPE_ERROR = 3;
     EVENT_WARNING(FILE_UPLOAD_ABORTED, 23, "File upload aborted")                                  \
     EVENT_WARNING(FILE_DOWNLOAD_ABORTED, 24, "File download aborted")                              \
     EVENT_WARNING(AUTO_RECALL_MODULE_MISMATCH, 25, "Auto-recall module mismatch")                  \
+    EVENT_WARNING(DLOG_WRITER_BEHIND, 26, "DLOG writer falling behind")                            \
     EVENT_INFO(WELCOME, 0, "Welcome!")                                                             \
     EVENT_INFO(POWER_UP, 1, "Power up")                                                            \
     EVENT_INFO(POWER_DOWN, 2, "Power down")                                                        \
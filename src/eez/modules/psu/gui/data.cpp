@@ -3597,6 +3597,94 @@ void data_channel_display_view_settings_yt_view_rate(data::DataOperationEnum ope
     }
 }
 
+static Channel &getStatisticsChannel(data::Cursor &cursor) {
+    int iChannel = cursor.i >= 0 ? cursor.i : (g_channel ? g_channel->channelIndex : 0);
+    return Channel::get(iChannel);
+}
+
+void data_channel_statistics_duration(data::DataOperationEnum operation, data::Cursor &cursor, data::Value &value) {
+    if (operation == data::DATA_OPERATION_GET) {
+        const Channel::Statistics &statistics = getStatisticsChannel(cursor).statistics;
+        value = MakeValue(statistics.getDuration(), UNIT_SECOND);
+    }
+}
+
+void data_channel_statistics_u_min(data::DataOperationEnum operation, data::Cursor &cursor, data::Value &value) {
+    if (operation == data::DATA_OPERATION_GET) {
+        const Channel::Statistics &statistics = getStatisticsChannel(cursor).statistics;
+        value = MakeValue(statistics.u.getMin(), UNIT_VOLT);
+    }
+}
+
+void data_channel_statistics_u_max(data::DataOperationEnum operation, data::Cursor &cursor, data::Value &value) {
+    if (operation == data::DATA_OPERATION_GET) {
+        const Channel::Statistics &statistics = getStatisticsChannel(cursor).statistics;
+        value = MakeValue(statistics.u.getMax(), UNIT_VOLT);
+    }
+}
+
+void data_channel_statistics_u_mean(data::DataOperationEnum operation, data::Cursor &cursor, data::Value &value) {
+    if (operation == data::DATA_OPERATION_GET) {
+        const Channel::Statistics &statistics = getStatisticsChannel(cursor).statistics;
+        value = MakeValue(statistics.u.getMean(), UNIT_VOLT);
+    }
+}
+
+void data_channel_statistics_u_rms(data::DataOperationEnum operation, data::Cursor &cursor, data::Value &value) {
+    if (operation == data::DATA_OPERATION_GET) {
+        const Channel::Statistics &statistics = getStatisticsChannel(cursor).statistics;
+        value = MakeValue(statistics.u.getRms(), UNIT_VOLT);
+    }
+}
+
+void data_channel_statistics_i_min(data::DataOperationEnum operation, data::Cursor &cursor, data::Value &value) {
+    if (operation == data::DATA_OPERATION_GET) {
+        const Channel::Statistics &statistics = getStatisticsChannel(cursor).statistics;
+        value = MakeValue(statistics.i.getMin(), UNIT_AMPER);
+    }
+}
+
+void data_channel_statistics_i_max(data::DataOperationEnum operation, data::Cursor &cursor, data::Value &value) {
+    if (operation == data::DATA_OPERATION_GET) {
+        const Channel::Statistics &statistics = getStatisticsChannel(cursor).statistics;
+        value = MakeValue(statistics.i.getMax(), UNIT_AMPER);
+    }
+}
+
+void data_channel_statistics_i_mean(data::DataOperationEnum operation, data::Cursor &cursor, data::Value &value) {
+    if (operation == data::DATA_OPERATION_GET) {
+        const Channel::Statistics &statistics = getStatisticsChannel(cursor).statistics;
+        value = MakeValue(statistics.i.getMean(), UNIT_AMPER);
+    }
+}
+
+void data_channel_statistics_i_rms(data::DataOperationEnum operation, data::Cursor &cursor, data::Value &value) {
+    if (operation == data::DATA_OPERATION_GET) {
+        const Channel::Statistics &statistics = getStatisticsChannel(cursor).statistics;
+        value = MakeValue(statistics.i.getRms(), UNIT_AMPER);
+    }
+}
+
+void data_channel_statistics_charge(data::DataOperationEnum operation, data::Cursor &cursor, data::Value &value) {
+    if (operation == data::DATA_OPERATION_GET) {
+        const Channel::Statistics &statistics = getStatisticsChannel(cursor).statistics;
+        value = MakeValue((float)statistics.ampHours, UNIT_AMPER_HOUR);
+    }
+}
+
+void data_channel_statistics_energy(data::DataOperationEnum operation, data::Cursor &cursor, data::Value &value) {
+    if (operation == data::DATA_OPERATION_GET) {
+        const Channel::Statistics &statistics = getStatisticsChannel(cursor).statistics;
+        value = MakeValue((float)statistics.wattHours, UNIT_WATT_HOUR);
+    }
+}
+
+void data_channel_statistics_count(data::DataOperationEnum operation, data::Cursor &cursor, data::Value &value) {
+    if (operation == data::DATA_OPERATION_GET) {
+        value = Value(getStatisticsChannel(cursor).statistics.i.count, VALUE_TYPE_UINT32);
+    }
+}
+
 void data_sys_encoder_confirmation_mode(data::DataOperationEnum operation, data::Cursor &cursor, data::Value &value) {
 #if OPTION_ENCODER
     if (operation == data::DATA_OPERATION_GET) {
@@ -441,7 +441,9 @@ void deleteFile() {
     strcat(filePath, fileItem->name);
 
     int err;
-    psu::sd_card::deleteFile(filePath, &err);
+    if (psu::sd_card::deleteFile(filePath, &err) && fileItem->type == FILE_TYPE_DLOG) {
+        psu::dlog_view::deletePyramidFile(filePath);
+    }
 
     loadDirectory();
 }
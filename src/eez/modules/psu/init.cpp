@@ -21,6 +21,7 @@
 #include <eez/system.h>
 
 #include <eez/modules/psu/psu.h>
+#include <eez/modules/psu/scheduler.h>
 
 namespace eez {
 namespace psu {
@@ -83,7 +84,8 @@ void mainLoop(const void *) {
 bool g_adcMeasureAllFinished = false;
 
 void oneIter() {
-    osEvent event = osMessageGet(g_psuMessageQueueId, 1);
+    // wait for the message only until the next task is due
+    osEvent event = osMessageGet(g_psuMessageQueueId, scheduler::getTimeoutMs());
     if (event.status == osEventMessage) {
     	uint32_t message = event.value.v;
     	uint32_t type = PSU_QUEUE_MESSAGE_TYPE(message);
@@ -101,9 +103,10 @@ void oneIter() {
             eez::psu::Channel::get(param).adcMeasureAll();
             g_adcMeasureAllFinished = true;
         }
-    } else {
-        tick();
     }
+
+    // also when messages keep coming, otherwise they would delay the tasks
+    tick();
 }
 
 bool measureAllAdcValuesOnChannel(int channelIndex) {
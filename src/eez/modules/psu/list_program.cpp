@@ -33,6 +33,7 @@
 #endif
 #include <eez/modules/psu/io_pins.h>
 #include <eez/system.h>
+#include <eez/memory.h>
 
 #define CONF_COUNTER_THRESHOLD_IN_SECONDS 5
 
@@ -60,13 +61,37 @@ static struct {
 
 static struct {
     int32_t counter;
-    int16_t it;
+    int32_t it;
     uint32_t nextPointTime;
     int32_t currentRemainingDwellTime;
     float currentTotalDwellTime;
     uint32_t lastTickCount;
 } g_execution[CH_MAX];
 
+// Number of points per channel kept in LIST_STREAM_BUFFER. PSU task executes
+// points from one half of the window while SCPI task loads the other half.
+#define LIST_STREAM_WINDOW_SIZE 1024
+
+static_assert(CH_MAX * LIST_STREAM_WINDOW_SIZE * sizeof(ListStreamPoint) <= LIST_STREAM_BUFFER_SIZE, "LIST_STREAM_BUFFER too small");
+
+static struct {
+    char filePath[MAX_PATH_LENGTH + 1];
+    uint32_t numPoints; // 0 if list is not streamed
+
+    // kept for the TRIGGER_ON_LIST_STOP_SET_TO_FIRST/LAST_STEP
+    ListStreamPoint firstPoint;
+    ListStreamPoint lastPoint;
+
+    // points are counted from the execution start, including the repeats
+    volatile uint32_t readIndex; // changed only by the PSU task
+    volatile uint32_t writeIndex; // changed only by the SCPI task
+
+    volatile bool startRequested;
+    volatile bool isPrimed;
+    volatile bool refillPending;
+    volatile bool loadFailed;
+} g_streams[CH_MAX];
+
 static bool g_active;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -86,6 +111,8 @@ void resetChannelList(Channel &channel) {
 
     g_channelsLists[i].count = 1;
 
+    g_streams[i].numPoints = 0;
+
     g_execution[i].counter = -1;
 }
 
@@ -99,6 +126,7 @@ void setDwellList(Channel &channel, float *list, uint16_t listLength) {
     memcpy(g_channelsLists[channel.channelIndex].dwellList, list, listLength * sizeof(float));
     g_channelsLists[channel.channelIndex].dwellListLength = listLength;
     g_channelsLists[channel.channelIndex].changed = true;
+    g_streams[channel.channelIndex].numPoints = 0;
 }
 
 float *getDwellList(Channel &channel, uint16_t *listLength) {
@@ -110,6 +138,7 @@ void setVoltageList(Channel &channel, float *list, uint16_t listLength) {
     memcpy(g_channelsLists[channel.channelIndex].voltageList, list, listLength * sizeof(float));
     g_channelsLists[channel.channelIndex].voltageListLength = listLength;
     g_channelsLists[channel.channelIndex].changed = true;
+    g_streams[channel.channelIndex].numPoints = 0;
 }
 
 float *getVoltageList(Channel &channel, uint16_t *listLength) {
@@ -121,6 +150,7 @@ void setCurrentList(Channel &channel, float *list, uint16_t listLength) {
     memcpy(g_channelsLists[channel.channelIndex].currentList, list, listLength * sizeof(float));
     g_channelsLists[channel.channelIndex].currentListLength = listLength;
     g_channelsLists[channel.channelIndex].changed = true;
+    g_streams[channel.channelIndex].numPoints = 0;
 }
 
 float *getCurrentList(Channel &channel, uint16_t *listLength) {
@@ -145,7 +175,8 @@ void setListCount(Channel &channel, uint16_t value) {
 }
 
 bool isListEmpty(Channel &channel) {
-    return g_channelsLists[channel.channelIndex].dwellListLength == 0 &&
+    return g_streams[channel.channelIndex].numPoints == 0 &&
+           g_channelsLists[channel.channelIndex].dwellListLength == 0 &&
            g_channelsLists[channel.channelIndex].voltageListLength == 0 &&
            g_channelsLists[channel.channelIndex].currentListLength == 0;
 }
@@ -161,6 +192,9 @@ bool areListLengthsEquivalent(uint16_t size1, uint16_t size2, uint16_t size3) {
 }
 
 bool areListLengthsEquivalent(Channel &channel) {
+    if (g_streams[channel.channelIndex].numPoints > 0) {
+        return true;
+    }
     return list::areListLengthsEquivalent(g_channelsLists[channel.channelIndex].dwellListLength,
                                           g_channelsLists[channel.channelIndex].voltageListLength,
                                           g_channelsLists[channel.channelIndex].currentListLength);
@@ -181,132 +215,174 @@ bool areVoltageAndCurrentListLengthsEquivalent(Channel &channel) {
                                     g_channelsLists[channel.channelIndex].currentListLength);
 }
 
-int checkLimits(int iChannel) {
-    Channel &channel = Channel::get(iChannel);
-
-    uint16_t voltageListLength = g_channelsLists[iChannel].voltageListLength;
-    uint16_t currentListLength = g_channelsLists[iChannel].currentListLength;
-
-    for (int j = 0; j < voltageListLength || j < currentListLength; ++j) {
-        float voltage = g_channelsLists[iChannel].voltageList[j % voltageListLength];
-        if (voltage > channel_dispatcher::getULimit(channel)) {
-            return SCPI_ERROR_VOLTAGE_LIMIT_EXCEEDED;
-        }
+static int checkLimits(Channel &channel, float voltage, float current) {
+    if (voltage > channel_dispatcher::getULimit(channel)) {
+        return SCPI_ERROR_VOLTAGE_LIMIT_EXCEEDED;
+    }
 
-        float current = g_channelsLists[iChannel].currentList[j % currentListLength];
-        if (current > channel_dispatcher::getILimit(channel)) {
-            return SCPI_ERROR_CURRENT_LIMIT_EXCEEDED;
-        }
+    if (current > channel_dispatcher::getILimit(channel)) {
+        return SCPI_ERROR_CURRENT_LIMIT_EXCEEDED;
+    }
 
-        if (voltage * current > channel_dispatcher::getPowerLimit(channel)) {
-            return SCPI_ERROR_POWER_LIMIT_EXCEEDED;
-        }
+    if (voltage * current > channel_dispatcher::getPowerLimit(channel)) {
+        return SCPI_ERROR_POWER_LIMIT_EXCEEDED;
     }
 
     return 0;
 }
 
-bool loadList(int iChannel, const char *filePath, int *err) {
-#if OPTION_SD_CARD
-    Channel &channel = Channel::get(iChannel);
+// Points from the file didn't go through LIST:VOLT, LIST:CURR and LIST:DWEL, so also the
+// ranges are checked here.
+static int checkStreamPoint(Channel &channel, const ListStreamPoint &point) {
+    if (!isfinite(point.voltage) || point.voltage < channel_dispatcher::getUMin(channel) || point.voltage > channel_dispatcher::getUMax(channel)) {
+        return SCPI_ERROR_DATA_OUT_OF_RANGE;
+    }
 
-    if (!sd_card::isMounted(err)) {
-        return false;
+    if (!isfinite(point.current) || point.current < channel_dispatcher::getIMin(channel) || point.current > channel_dispatcher::getIMax(channel)) {
+        return SCPI_ERROR_DATA_OUT_OF_RANGE;
     }
 
-    if (!sd_card::exists(filePath, err)) {
-        if (err) {
-            *err = SCPI_ERROR_LIST_NOT_FOUND;
-        }
-        return false;
+    if (!isfinite(point.dwell) || point.dwell < LIST_DWELL_MIN || point.dwell > LIST_DWELL_MAX) {
+        return SCPI_ERROR_DATA_OUT_OF_RANGE;
     }
 
-    File file;
-    if (!file.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+    return checkLimits(channel, point.voltage, point.current);
+}
+
+int checkLimits(int iChannel) {
+    Channel &channel = Channel::get(iChannel);
+
+    if (g_streams[iChannel].numPoints > 0) {
+        // other points are checked when executed
+        int err = checkStreamPoint(channel, g_streams[iChannel].firstPoint);
         if (err) {
-            *err = SCPI_ERROR_MASS_STORAGE_ERROR;
+            return err;
         }
-        return false;
+        return checkStreamPoint(channel, g_streams[iChannel].lastPoint);
     }
 
-    float dwellList[MAX_LIST_LENGTH];
-    uint16_t dwellListLength = 0;
+    uint16_t voltageListLength = g_channelsLists[iChannel].voltageListLength;
+    uint16_t currentListLength = g_channelsLists[iChannel].currentListLength;
 
-    float voltageList[MAX_LIST_LENGTH];
-    uint16_t voltageListLength = 0;
+    for (int j = 0; j < voltageListLength || j < currentListLength; ++j) {
+        int err = checkLimits(channel,
+            g_channelsLists[iChannel].voltageList[j % voltageListLength],
+            g_channelsLists[iChannel].currentList[j % currentListLength]);
+        if (err) {
+            return err;
+        }
+    }
 
-    float currentList[MAX_LIST_LENGTH];
-    uint16_t currentListLength = 0;
+    return 0;
+}
 
-    bool success = true;
+#if OPTION_SD_CARD
+static bool parseList(sd_card::BufferedFileReader &reader,
+                      float *dwellList, uint16_t &dwellListLength,
+                      float *voltageList, uint16_t &voltageListLength,
+                      float *currentList, uint16_t &currentListLength) {
+    dwellListLength = 0;
+    voltageListLength = 0;
+    currentListLength = 0;
 
     for (int i = 0; i < MAX_LIST_LENGTH; ++i) {
-        sd_card::matchZeroOrMoreSpaces(file);
-        if (!file.available()) {
+        sd_card::matchZeroOrMoreSpaces(reader);
+        if (!reader.available()) {
             break;
         }
 
         float value;
 
-        if (sd_card::match(file, LIST_CSV_FILE_NO_VALUE_CHAR)) {
+        if (sd_card::match(reader, LIST_CSV_FILE_NO_VALUE_CHAR)) {
             if (i < dwellListLength) {
-                success = false;
-                break;
+                return false;
             }
-        } else if (sd_card::match(file, value)) {
+        } else if (sd_card::match(reader, value)) {
             if (i == dwellListLength) {
                 dwellList[i] = value;
                 dwellListLength = i + 1;
             } else {
-                success = false;
-                break;
+                return false;
             }
         } else {
-            success = false;
-            break;
+            return false;
         }
 
-        sd_card::match(file, CSV_SEPARATOR);
+        sd_card::match(reader, CSV_SEPARATOR);
 
-        if (sd_card::match(file, LIST_CSV_FILE_NO_VALUE_CHAR)) {
+        if (sd_card::match(reader, LIST_CSV_FILE_NO_VALUE_CHAR)) {
             if (i < voltageListLength) {
-                success = false;
-                break;
+                return false;
             }
-        } else if (sd_card::match(file, value)) {
+        } else if (sd_card::match(reader, value)) {
             if (i == voltageListLength) {
                 voltageList[i] = value;
                 ++voltageListLength;
             } else {
-                success = false;
-                break;
+                return false;
             }
         } else {
-            success = false;
-            break;
+            return false;
         }
 
-        sd_card::match(file, CSV_SEPARATOR);
+        sd_card::match(reader, CSV_SEPARATOR);
 
-        if (sd_card::match(file, LIST_CSV_FILE_NO_VALUE_CHAR)) {
+        if (sd_card::match(reader, LIST_CSV_FILE_NO_VALUE_CHAR)) {
             if (i < currentListLength) {
-                success = false;
-                break;
+                return false;
             }
-        } else if (sd_card::match(file, value)) {
+        } else if (sd_card::match(reader, value)) {
             if (i == currentListLength) {
                 currentList[i] = value;
                 ++currentListLength;
             } else {
-                success = false;
-                break;
+                return false;
             }
         } else {
-            success = false;
-            break;
+            return false;
+        }
+    }
+
+    return true;
+}
+#endif
+
+bool loadList(int iChannel, const char *filePath, int *err) {
+#if OPTION_SD_CARD
+    Channel &channel = Channel::get(iChannel);
+
+    if (!sd_card::isMounted(err)) {
+        return false;
+    }
+
+    if (!sd_card::exists(filePath, err)) {
+        if (err) {
+            *err = SCPI_ERROR_LIST_NOT_FOUND;
         }
+        return false;
     }
 
+    File file;
+    if (!file.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        if (err) {
+            *err = SCPI_ERROR_MASS_STORAGE_ERROR;
+        }
+        return false;
+    }
+
+    float dwellList[MAX_LIST_LENGTH];
+    uint16_t dwellListLength = 0;
+
+    float voltageList[MAX_LIST_LENGTH];
+    uint16_t voltageListLength = 0;
+
+    float currentList[MAX_LIST_LENGTH];
+    uint16_t currentListLength = 0;
+
+    uint8_t buffer[sd_card::FILE_READ_BUFFER_SIZE];
+    sd_card::BufferedFileReader reader(file, buffer, sizeof(buffer));
+    bool success = parseList(reader, dwellList, dwellListLength, voltageList, voltageListLength, currentList, currentListLength);
+
     file.close();
 
     if (success) {
@@ -395,6 +471,246 @@ bool saveList(int iChannel, const char *filePath, int *err) {
 #endif
 }
 
+static ListStreamPoint *getStreamWindow(int iChannel) {
+    return (ListStreamPoint *)LIST_STREAM_BUFFER + iChannel * LIST_STREAM_WINDOW_SIZE;
+}
+
+bool loadListStream(int iChannel, const char *filePath, int *err) {
+#if OPTION_SD_CARD
+    if (!sd_card::isMounted(err)) {
+        return false;
+    }
+
+    if (!sd_card::exists(filePath, err)) {
+        if (err) {
+            *err = SCPI_ERROR_LIST_NOT_FOUND;
+        }
+        return false;
+    }
+
+    File file;
+    if (!file.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        if (err) {
+            *err = SCPI_ERROR_MASS_STORAGE_ERROR;
+        }
+        return false;
+    }
+
+    ListStreamFileHeader header;
+    ListStreamPoint firstPoint;
+    ListStreamPoint lastPoint;
+
+    bool success =
+        file.read(&header, sizeof(header)) == sizeof(header) &&
+        header.magic == LIST_STREAM_FILE_MAGIC &&
+        header.version == LIST_STREAM_FILE_VERSION &&
+        header.numPoints > 0 &&
+        file.size() >= sizeof(header) + (uint64_t)header.numPoints * sizeof(ListStreamPoint) &&
+        file.read(&firstPoint, sizeof(firstPoint)) == sizeof(firstPoint) &&
+        file.seek(sizeof(header) + (header.numPoints - 1) * sizeof(ListStreamPoint)) &&
+        file.read(&lastPoint, sizeof(lastPoint)) == sizeof(lastPoint);
+
+    file.close();
+
+    if (!success) {
+        // TODO replace with more specific error
+        if (err) {
+            *err = SCPI_ERROR_EXECUTION_ERROR;
+        }
+        return false;
+    }
+
+    auto &stream = g_streams[iChannel];
+    strcpy(stream.filePath, filePath);
+    stream.firstPoint = firstPoint;
+    stream.lastPoint = lastPoint;
+    stream.readIndex = 0;
+    stream.writeIndex = 0;
+    stream.isPrimed = false;
+    stream.numPoints = header.numPoints;
+
+    return true;
+#else
+    if (err) {
+        *err = SCPI_ERROR_HARDWARE_MISSING;
+    }
+    return false;
+#endif
+}
+
+void streamRefill(int iChannel) {
+#if OPTION_SD_CARD
+    auto &stream = g_streams[iChannel];
+
+    // start of the execution resets the window
+    bool starting = stream.startRequested;
+    if (starting) {
+        stream.startRequested = false;
+        stream.writeIndex = 0;
+    }
+
+    if (stream.numPoints == 0 || (!starting && g_execution[iChannel].counter < 0)) {
+        stream.refillPending = false;
+        return;
+    }
+
+    uint32_t writeIndex = stream.writeIndex;
+    uint32_t numPointsToLoad = LIST_STREAM_WINDOW_SIZE - (writeIndex - stream.readIndex);
+
+    File file;
+    if (file.open(stream.filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        ListStreamPoint *window = getStreamWindow(iChannel);
+
+        while (numPointsToLoad > 0) {
+            // list is repeated, so file is read in a circle
+            uint32_t windowIndex = writeIndex % LIST_STREAM_WINDOW_SIZE;
+            uint32_t pointIndex = writeIndex % stream.numPoints;
+            uint32_t n = MIN(numPointsToLoad, MIN(LIST_STREAM_WINDOW_SIZE - windowIndex, stream.numPoints - pointIndex));
+
+            int length = n * sizeof(ListStreamPoint);
+            if (!file.seek(sizeof(ListStreamFileHeader) + pointIndex * sizeof(ListStreamPoint)) ||
+                file.read(window + windowIndex, length) != length) {
+                stream.loadFailed = true;
+                break;
+            }
+
+            writeIndex += n;
+            numPointsToLoad -= n;
+
+            stream.writeIndex = writeIndex;
+        }
+
+        file.close();
+    } else {
+        stream.loadFailed = true;
+    }
+
+    if (starting) {
+        stream.isPrimed = true;
+    }
+
+    stream.refillPending = false;
+#endif
+}
+
+static void requestStreamRefill(int iChannel) {
+#if OPTION_SD_CARD
+    if (osThreadGetId() != g_scpiTaskHandle) {
+        if (g_streams[iChannel].refillPending) {
+            return;
+        }
+        g_streams[iChannel].refillPending = true;
+        osMessagePut(g_scpiMessageQueueId, SCPI_QUEUE_MESSAGE(SCPI_QUEUE_MESSAGE_TARGET_NONE, SCPI_QUEUE_MESSAGE_LIST_STREAM_REFILL, iChannel), osWaitForever);
+    } else {
+        streamRefill(iChannel);
+    }
+#endif
+}
+
+// Takes the next point from the window, fails if SCPI task didn't load it in time.
+static bool getNextStreamPoint(int iChannel, ListStreamPoint &point, int *err) {
+    auto &stream = g_streams[iChannel];
+
+    uint32_t readIndex = stream.readIndex;
+    if ((int32_t)(stream.writeIndex - readIndex) <= 0) {
+        *err = stream.loadFailed ? SCPI_ERROR_MASS_STORAGE_ERROR : SCPI_ERROR_LIST_STREAM_UNDERRUN;
+        return false;
+    }
+
+    point = getStreamWindow(iChannel)[readIndex % LIST_STREAM_WINDOW_SIZE];
+    stream.readIndex = ++readIndex;
+
+    if (stream.writeIndex - readIndex <= LIST_STREAM_WINDOW_SIZE / 2) {
+        requestStreamRefill(iChannel);
+    }
+
+    return true;
+}
+
+#if defined(EEZ_PLATFORM_SIMULATOR) && OPTION_SD_CARD
+
+static uint32_t benchmarkLoad(const char *filePath, uint8_t *buffer, uint32_t bufferSize, int numIterations, bool &success) {
+    float dwellList[MAX_LIST_LENGTH];
+    uint16_t dwellListLength;
+    float voltageList[MAX_LIST_LENGTH];
+    uint16_t voltageListLength;
+    float currentList[MAX_LIST_LENGTH];
+    uint16_t currentListLength;
+
+    uint32_t start = micros();
+
+    for (int i = 0; i < numIterations; i++) {
+        File file;
+        if (!file.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+            success = false;
+            break;
+        }
+
+        sd_card::BufferedFileReader reader(file, buffer, bufferSize);
+        if (!parseList(reader, dwellList, dwellListLength, voltageList, voltageListLength, currentList, currentListLength) ||
+            dwellListLength != MAX_LIST_LENGTH) {
+            success = false;
+        }
+
+        file.close();
+    }
+
+    return micros() - start;
+}
+
+int benchmark(int numIterations, float &unbufferedLoadTime, float &bufferedLoadTime) {
+    int err;
+    if (!sd_card::isMounted(&err)) {
+        return err;
+    }
+
+    char filePath[MAX_PATH_LENGTH + 1];
+    strcpy(filePath, LISTS_DIR);
+    strcat(filePath, PATH_SEPARATOR "__benchmark.list");
+
+    sd_card::makeParentDir(filePath);
+
+    File file;
+    if (!file.open(filePath, FILE_CREATE_ALWAYS | FILE_WRITE)) {
+        return SCPI_ERROR_MASS_STORAGE_ERROR;
+    }
+
+    // max. size list, every value has 4 decimal digits as written by saveList
+    for (int i = 0; i < MAX_LIST_LENGTH; ++i) {
+        file.print(0.0010f * (i + 1), 4);
+        file.print(CSV_SEPARATOR);
+        file.print(10.0f + 0.0125f * i, 4);
+        file.print(CSV_SEPARATOR);
+        file.print(1.5f - 0.0025f * i, 4);
+        file.print('\n');
+    }
+
+    file.close();
+
+    bool success = true;
+
+    // 1 byte buffer, i.e. one file system read per character as before
+    uint8_t byte;
+    uint32_t unbufferedDuration = benchmarkLoad(filePath, &byte, 1, numIterations, success);
+
+    uint8_t buffer[sd_card::FILE_READ_BUFFER_SIZE];
+    uint32_t bufferedDuration = benchmarkLoad(filePath, buffer, sizeof(buffer), numIterations, success);
+
+    sd_card::deleteFile(filePath, NULL);
+
+    if (!success) {
+        return SCPI_ERROR_EXECUTION_ERROR;
+    }
+
+    // in milliseconds per list
+    unbufferedLoadTime = unbufferedDuration / 1000.0f / numIterations;
+    bufferedLoadTime = bufferedDuration / 1000.0f / numIterations;
+
+    return SCPI_RES_OK;
+}
+
+#endif
+
 void updateChannelsWithVisibleCountersList();
 
 void setActive(bool active, bool forceUpdate = false) {
@@ -412,12 +728,27 @@ void setActive(bool active, bool forceUpdate = false) {
 void executionStart(Channel &channel) {
     g_execution[channel.channelIndex].it = -1;
     g_execution[channel.channelIndex].counter = g_channelsLists[channel.channelIndex].count;
+
+    auto &stream = g_streams[channel.channelIndex];
+    if (stream.numPoints > 0) {
+        // execution starts after SCPI task loads the window
+        stream.isPrimed = false;
+        stream.loadFailed = false;
+        stream.readIndex = 0;
+        stream.startRequested = true;
+        requestStreamRefill(channel.channelIndex);
+    }
+
     setActive(true, true);
 
     tick(micros());
 }
 
 int maxListsSize(Channel &channel) {
+    if (g_streams[channel.channelIndex].numPoints > 0) {
+        return g_streams[channel.channelIndex].numPoints;
+    }
+
     uint16_t maxSize = 0;
 
     if (g_channelsLists[channel.channelIndex].voltageListLength > maxSize) {
@@ -435,21 +766,9 @@ int maxListsSize(Channel &channel) {
     return maxSize;
 }
 
-bool setListValue(Channel &channel, int16_t it, int *err) {
-    float voltage = g_channelsLists[channel.channelIndex].voltageList[it % g_channelsLists[channel.channelIndex].voltageListLength];
-    if (voltage > channel_dispatcher::getULimit(channel)) {
-        *err = SCPI_ERROR_VOLTAGE_LIMIT_EXCEEDED;
-        return false;
-    }
-
-    float current = g_channelsLists[channel.channelIndex].currentList[it % g_channelsLists[channel.channelIndex].currentListLength];
-    if (current > channel_dispatcher::getILimit(channel)) {
-        *err = SCPI_ERROR_CURRENT_LIMIT_EXCEEDED;
-        return false;
-    }
-
-    if (voltage * current > channel_dispatcher::getPowerLimit(channel)) {
-        *err = SCPI_ERROR_POWER_LIMIT_EXCEEDED;
+static bool setListValue(Channel &channel, float voltage, float current, int *err) {
+    *err = checkLimits(channel, voltage, current);
+    if (*err) {
         return false;
     }
 
@@ -464,6 +783,18 @@ bool setListValue(Channel &channel, int16_t it, int *err) {
     return true;
 }
 
+// For the streamed list only the first and the last point are available.
+bool setListValue(Channel &channel, int32_t it, int *err) {
+    auto &stream = g_streams[channel.channelIndex];
+    if (stream.numPoints > 0) {
+        auto &point = it == 0 ? stream.firstPoint : stream.lastPoint;
+        return setListValue(channel, point.voltage, point.current, err);
+    }
+
+    auto &lists = g_channelsLists[channel.channelIndex];
+    return setListValue(channel, lists.voltageList[it % lists.voltageListLength], lists.currentList[it % lists.currentListLength], err);
+}
+
 void tick(uint32_t tick_usec) {
     bool active = false;
 
@@ -493,7 +824,7 @@ void tick(uint32_t tick_usec) {
                 bool set = false;
 
                 if (g_execution[i].it == -1) {
-                    set = true;
+                    set = g_streams[i].numPoints == 0 || g_streams[i].isPrimed;
                 } else {
                     g_execution[i].currentRemainingDwellTime =
                         g_execution[i].nextPointTime - tickCount;
@@ -517,16 +848,30 @@ void tick(uint32_t tick_usec) {
                     }
 
                     int err;
-                    if (!setListValue(channel, g_execution[i].it, &err)) {
+                    float dwell;
+                    bool success;
+                    if (g_streams[i].numPoints > 0) {
+                        ListStreamPoint point;
+                        success = getNextStreamPoint(i, point, &err);
+                        if (success) {
+                            // bad point aborts the list before anything is applied to the output
+                            err = checkStreamPoint(channel, point);
+                            success = err == 0 && setListValue(channel, point.voltage, point.current, &err);
+                        }
+                        dwell = point.dwell;
+                    } else {
+                        success = setListValue(channel, g_execution[i].it, &err);
+                        dwell = g_channelsLists[i].dwellList[g_execution[i].it % g_channelsLists[i].dwellListLength];
+                    }
+
+                    if (!success) {
                         setActive(false);
                         generateError(err);
                         abort();
                         return;
                     }
 
-                    g_execution[i].currentTotalDwellTime =
-                        g_channelsLists[i]
-                            .dwellList[g_execution[i].it % g_channelsLists[i].dwellListLength];
+                    g_execution[i].currentTotalDwellTime = dwell;
                     // if dwell time is greater then CONF_COUNTER_THRESHOLD_IN_SECONDS ...
                     if (g_execution[i].currentTotalDwellTime > CONF_COUNTER_THRESHOLD_IN_SECONDS) {
                         // ... then count in milliseconds
@@ -559,6 +904,15 @@ bool isActive(Channel &channel) {
     return g_execution[channel.channelIndex].counter >= 0;
 }
 
+bool isStreamActive() {
+    for (int i = 0; i < CH_NUM; i++) {
+        if (g_streams[i].numPoints > 0 && isActive(Channel::get(i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
 int g_numChannelsWithVisibleCounters;
 int g_channelsWithVisibleCounters[CH_MAX];
 
@@ -566,6 +920,11 @@ void updateChannelsWithVisibleCountersList() {
     g_numChannelsWithVisibleCounters = 0;
     for (int channelIndex = 0; channelIndex < CH_NUM; channelIndex++) {
         if (g_execution[channelIndex].counter >= 0) {
+            if (g_streams[channelIndex].numPoints > 0) {
+                g_channelsWithVisibleCounters[g_numChannelsWithVisibleCounters++] = channelIndex;
+                continue;
+            }
+
             auto &channelLists = g_channelsLists[channelIndex];
             for (int j = 0; j < channelLists.dwellListLength; j++) {
                 if (channelLists.dwellList[j] >= CONF_LIST_COUNDOWN_DISPLAY_THRESHOLD) {
@@ -24,6 +24,24 @@ namespace eez {
 namespace psu {
 namespace list {
 
+// Binary list file for the streamed execution: ListStreamFileHeader followed by
+// numPoints ListStreamPoint's. There is no limit on the number of points, only
+// a small window of points is kept in memory while list is executed.
+static const uint32_t LIST_STREAM_FILE_MAGIC = 0x4C5A4545; // "EEZL"
+static const uint32_t LIST_STREAM_FILE_VERSION = 1;
+
+struct ListStreamFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numPoints;
+};
+
+struct ListStreamPoint {
+    float dwell;
+    float voltage;
+    float current;
+};
+
 void init();
 
 void resetChannelList(Channel &channel);
@@ -58,11 +76,23 @@ int checkLimits(int iChannel);
 bool loadList(int iChannel, const char *filePath, int *err);
 bool saveList(int iChannel, const char *filePath, int *err);
 
+// Channel executes list from the file until other list is set or loaded.
+bool loadListStream(int iChannel, const char *filePath, int *err);
+// Loads next points into the window, executed by the SCPI task.
+void streamRefill(int iChannel);
+// Returns true if some channel is executing the list from the file.
+bool isStreamActive();
+
+#if defined(EEZ_PLATFORM_SIMULATOR) && OPTION_SD_CARD
+// Measures load time (in ms) of the max. size list file with and without read buffering.
+int benchmark(int numIterations, float &unbufferedLoadTime, float &bufferedLoadTime);
+#endif
+
 void executionStart(Channel &channel);
 
 int maxListsSize(Channel &channel);
 
-bool setListValue(Channel &channel, int16_t it, int *err);
+bool setListValue(Channel &channel, int32_t it, int *err);
 
 void tick(uint32_t tick_usec);
 
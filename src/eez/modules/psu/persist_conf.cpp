@@ -1192,6 +1192,10 @@ void enableMqtt(bool enable) {
     setMqttSettings(enable, persist_conf::devConf.mqttHost, persist_conf::devConf.mqttPort, persist_conf::devConf.mqttUsername, persist_conf::devConf.mqttPassword, persist_conf::devConf.mqttPeriod);
 }
 
+void setMqttTelemetryFormat(uint8_t mqttTelemetryFormat) {
+    g_devConf.mqttTelemetryFormat = mqttTelemetryFormat;
+}
+
 void setSdLocked(bool sdLocked) {
     g_devConf.sdLocked = sdLocked ? 1 : 0;
 }
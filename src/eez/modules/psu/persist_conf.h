@@ -173,7 +173,8 @@ struct DeviceConfiguration {
     // block 7
     UserSwitchAction userSwitchAction;
     SortFilesOption sortFilesOption;
-    uint8_t reserved7[56];
+    uint8_t mqttTelemetryFormat;
+    uint8_t reserved7[55];
 
     // block 8
     char ethernetHostName[32 + 1];
@@ -288,6 +289,7 @@ void setNtpSettings(bool enable, const char *ntpServer);
 
 bool setMqttSettings(bool enable, const char *host, uint16_t port, const char *username, const char *password, float period);
 void enableMqtt(bool enable);
+void setMqttTelemetryFormat(uint8_t mqttTelemetryFormat);
 
 void setSdLocked(bool sdLocked);
 bool isSdLocked();
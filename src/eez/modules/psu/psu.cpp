@@ -18,6 +18,7 @@
 
 #include <eez/modules/psu/psu.h>
 
+#include <eez/debug.h>
 #include <eez/system.h>
 
 #include <eez/modules/psu/init.h>
@@ -62,6 +63,7 @@
 #include <eez/modules/psu/list_program.h>
 #include <eez/modules/psu/trigger.h>
 #include <eez/modules/psu/ontime.h>
+#include <eez/modules/psu/scheduler.h>
 
 #include <eez/modules/bp3c/relays.h>
 #include <eez/modules/bp3c/eeprom.h>
@@ -196,6 +198,7 @@ void init() {
 
 #if OPTION_SD_CARD
     sd_card::init();
+    dlog_record::init();
 #endif
 
     bp3c::relays::init();
@@ -797,36 +800,12 @@ void onProtectionTripped() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-typedef void (*TickFunc)(uint32_t tickCount);
-static TickFunc g_tickFuncs[] = {
-    temperature::tick,
-#if OPTION_FAN
-    aux_ps::fan::tick,
-#endif
-    datetime::tick,
-    mcu::battery::tick,
-    idle::tick
-};
-static const int NUM_TICK_FUNCS = sizeof(g_tickFuncs) / sizeof(TickFunc);
-static int g_tickFuncIndex = 0;
+DebugProbeDefine(g_tickProbe, "psu:tick");
 
 void tick() {
-    uint32_t tickCount = micros();
-
-    dlog_record::tick(tickCount);
-
-    for (int i = 0; i < CH_NUM; ++i) {
-        Channel::get(i).tick(tickCount);
-    }
-
-    io_pins::tick(tickCount);
-
-    trigger::tick(tickCount);
-
-    list::tick(tickCount);
-
-    g_tickFuncs[g_tickFuncIndex](tickCount);
-    g_tickFuncIndex = (g_tickFuncIndex + 1) % NUM_TICK_FUNCS;
+    DebugProbeStart(g_tickProbe);
+    scheduler::tick();
+    DebugProbeFinish(g_tickProbe);
 
     if (g_diagCallback) {
         g_diagCallback();
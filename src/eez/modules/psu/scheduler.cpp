@@ -0,0 +1,217 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+
+#include <eez/debug.h>
+#include <eez/system.h>
+
+#if defined(EEZ_PLATFORM_STM32)
+#include <eez/platform/stm32/dwt_delay.h>
+#endif
+
+#include <eez/modules/psu/psu.h>
+
+#include <eez/modules/psu/datetime.h>
+#include <eez/modules/psu/dlog_record.h>
+#include <eez/modules/psu/idle.h>
+#include <eez/modules/psu/io_pins.h>
+#include <eez/modules/psu/list_program.h>
+#include <eez/modules/psu/scheduler.h>
+#include <eez/modules/psu/temperature.h>
+#include <eez/modules/psu/trigger.h>
+
+#if OPTION_FAN
+#include <eez/modules/aux_ps/fan.h>
+#endif
+
+#include <eez/modules/mcu/battery.h>
+
+namespace eez {
+namespace psu {
+namespace scheduler {
+
+static void channelsTick(uint32_t tickCount) {
+    for (int i = 0; i < CH_NUM; ++i) {
+        Channel::get(i).tick(tickCount);
+    }
+}
+
+// Tasks due in the same tick are executed in this order.
+static Task g_tasks[] = {
+    // name, function, period, budget, phase (all in microseconds)
+    { "dlog", dlog_record::tick, 1000, 200, 0 },
+    { "channels", channelsTick, 1000, 500, 0 },
+    { "io_pins", io_pins::tick, 1000, 100, 0 },
+    { "trigger", trigger::tick, 1000, 100, 0 },
+    { "list", list::tick, 1000, 200, 0 },
+    { "temperature", temperature::tick, 5000, 300, 0 },
+#if OPTION_FAN
+    { "fan", aux_ps::fan::tick, 5000, 200, 1000 },
+#endif
+    { "datetime", datetime::tick, 5000, 200, 2000 },
+    { "battery", mcu::battery::tick, 5000, 200, 3000 },
+    { "idle", idle::tick, 5000, 100, 4000 },
+};
+
+static const int NUM_TASKS = sizeof(g_tasks) / sizeof(Task);
+
+#ifdef DEBUG
+// one for each task, in the same order
+static eez::debug::DebugProbe g_taskProbes[] = {
+    eez::debug::DebugProbe("task:dlog"),
+    eez::debug::DebugProbe("task:channels"),
+    eez::debug::DebugProbe("task:io_pins"),
+    eez::debug::DebugProbe("task:trigger"),
+    eez::debug::DebugProbe("task:list"),
+    eez::debug::DebugProbe("task:temperature"),
+#if OPTION_FAN
+    eez::debug::DebugProbe("task:fan"),
+#endif
+    eez::debug::DebugProbe("task:datetime"),
+    eez::debug::DebugProbe("task:battery"),
+    eez::debug::DebugProbe("task:idle"),
+};
+
+static_assert(sizeof(g_taskProbes) / sizeof(eez::debug::DebugProbe) == NUM_TASKS, "one probe is required for each task");
+#endif
+
+static bool g_initialized;
+static volatile bool g_resetStatistics;
+
+#if defined(EEZ_PLATFORM_STM32)
+static uint32_t g_time;
+static uint32_t g_lastCycleCount;
+#endif
+
+// Time base for scheduling and measurements, in microseconds.
+static uint32_t getTime() {
+#if defined(EEZ_PLATFORM_STM32)
+    // micros() has 1 ms resolution on STM32, so DWT cycle counter is used instead. It wraps around
+    // every ~20 seconds, but it is read on every tick, i.e. at least every few milliseconds.
+    uint32_t cycleCount = *DWT_CYCCNT;
+    uint32_t microseconds = (cycleCount - g_lastCycleCount) / g_cyclesPerMicrosecond;
+    g_lastCycleCount += microseconds * g_cyclesPerMicrosecond;
+    g_time += microseconds;
+    return g_time;
+#else
+    return micros();
+#endif
+}
+
+static void init() {
+    uint32_t time = getTime();
+    for (int i = 0; i < NUM_TASKS; i++) {
+        g_tasks[i].nextRunTime = time + g_tasks[i].phase;
+    }
+
+    g_initialized = true;
+}
+
+void tick() {
+    if (!g_initialized) {
+        init();
+    }
+
+    if (g_resetStatistics) {
+        for (int i = 0; i < NUM_TASKS; i++) {
+            memset(&g_tasks[i].statistics, 0, sizeof(TaskStatistics));
+        }
+        g_resetStatistics = false;
+    }
+
+    // tasks are still getting the same tick count as before
+    uint32_t tickCount = micros();
+
+    for (int i = 0; i < NUM_TASKS; i++) {
+        Task &task = g_tasks[i];
+
+        uint32_t startTime = getTime();
+        int32_t jitter = (int32_t)(startTime - task.nextRunTime);
+        if (jitter < 0) {
+            continue;
+        }
+
+        DebugProbeStart(g_taskProbes[i]);
+        task.func(tickCount);
+        DebugProbeFinish(g_taskProbes[i]);
+
+        uint32_t duration = getTime() - startTime;
+
+        TaskStatistics &statistics = task.statistics;
+        statistics.numRuns++;
+        statistics.totalJitter += jitter;
+        if ((uint32_t)jitter > statistics.maxJitter) {
+            statistics.maxJitter = jitter;
+        }
+        if (duration > statistics.maxDuration) {
+            statistics.maxDuration = duration;
+        }
+        if (duration > task.budget) {
+            statistics.numOverruns++;
+        }
+
+        task.nextRunTime += task.period;
+
+        if ((int32_t)(startTime - task.nextRunTime) >= 0) {
+            // more than a whole period late, skip the missed runs instead of running them back to back
+            uint32_t numMissedPeriods = (startTime - task.nextRunTime) / task.period + 1;
+            statistics.numMissedPeriods += numMissedPeriods;
+            task.nextRunTime += numMissedPeriods * task.period;
+        }
+    }
+}
+
+uint32_t getTimeoutMs() {
+    // PSU thread always blocks for at least 1 ms, also when the tasks are late, because it has
+    // higher priority and it would otherwise starve the GUI, SCPI and ethernet threads
+    if (!g_initialized) {
+        return 1;
+    }
+
+    uint32_t time = getTime();
+
+    int32_t timeout = g_tasks[0].nextRunTime - time;
+    for (int i = 1; i < NUM_TASKS; i++) {
+        int32_t taskTimeout = g_tasks[i].nextRunTime - time;
+        if (taskTimeout < timeout) {
+            timeout = taskTimeout;
+        }
+    }
+
+    if (timeout <= 1000) {
+        return 1;
+    }
+
+    return (timeout + 999) / 1000;
+}
+
+int getNumTasks() {
+    return NUM_TASKS;
+}
+
+const Task &getTask(int taskIndex) {
+    return g_tasks[taskIndex];
+}
+
+void resetStatistics() {
+    g_resetStatistics = true;
+}
+
+} // namespace scheduler
+} // namespace psu
+} // namespace eez
@@ -0,0 +1,62 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+
+namespace eez {
+namespace psu {
+namespace scheduler {
+
+typedef void (*TaskFunc)(uint32_t tickCount);
+
+struct TaskStatistics {
+    uint32_t numRuns;
+    uint32_t numOverruns; // runs that took longer than the budget
+    uint32_t numMissedPeriods; // periods skipped because task started too late
+    uint32_t maxDuration; // in microseconds
+    uint32_t maxJitter; // max. delay of the start after the scheduled time, in microseconds
+    uint64_t totalJitter; // for the average jitter
+};
+
+struct Task {
+    const char *name;
+    TaskFunc func;
+    uint32_t period; // in microseconds
+    uint32_t budget; // in microseconds
+    uint32_t phase; // offset of the first run, so slow tasks don't run in the same tick
+
+    uint32_t nextRunTime;
+    TaskStatistics statistics;
+};
+
+// Runs the PSU tasks which are due, called from the PSU thread.
+void tick();
+
+// How long PSU thread can wait for the message before the next task is due, at least 1 ms.
+uint32_t getTimeoutMs();
+
+int getNumTasks();
+const Task &getTask(int taskIndex);
+
+// Statistics are cleared by the PSU thread on the next tick.
+void resetStatistics();
+
+} // namespace scheduler
+} // namespace psu
+} // namespace eez
@@ -0,0 +1,442 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <eez/debug.h>
+#include <eez/memory.h>
+#include <eez/system.h>
+#include <eez/util.h>
+
+#include <eez/modules/psu/scpi/command_index.h>
+
+// Every pattern is split into keywords, e.g. "[SOURce#]:VOLTage[:LEVel]?" into
+// SOURce# (optional), VOLTage and LEVel (optional), and inserted into the trie,
+// so patterns with the same beginning share the nodes. While resolving the header,
+// optional keyword can be either matched or skipped, so trie gives all the patterns
+// which could match the header. Those are confirmed with SCPI_Match, in the table
+// order, which makes the result exactly the same as with the linear search.
+
+namespace eez {
+namespace psu {
+namespace scpi {
+namespace command_index {
+
+static const uint16_t NONE = 0xFFFF;
+
+static const int MAX_COMMANDS = 1024;
+static const int MAX_MNEMONICS = 16;
+
+static const uint8_t FLAG_OPTIONAL = 1;
+static const uint8_t FLAG_NUMERIC_SUFFIX = 2;
+
+struct Node {
+    // keyword is stored as the position inside the pattern of the command which added the node
+    uint16_t command;
+    uint8_t keywordOffset;
+    uint8_t keywordLength; // without '#'
+    uint8_t shortLength;
+    uint8_t flags;
+    uint16_t firstChild;
+    uint16_t nextSibling;
+    // commands ending at this node, in table order, linked through g_nextCommand
+    uint16_t firstCommand;
+    uint16_t firstQueryCommand;
+};
+
+static uint16_t * const g_nextCommand = (uint16_t *)SCPI_COMMAND_INDEX_MEMORY;
+static Node * const g_nodes = (Node *)(SCPI_COMMAND_INDEX_MEMORY + MAX_COMMANDS * sizeof(uint16_t));
+static const int MAX_NODES = (SCPI_COMMAND_INDEX_MEMORY_SIZE - MAX_COMMANDS * sizeof(uint16_t)) / sizeof(Node);
+
+static const scpi_command_t *g_commands;
+static int g_numNodes;
+
+struct Lookup {
+    const char *header;
+    size_t len;
+    bool isQuery;
+    int numMnemonics;
+    const char *mnemonics[MAX_MNEMONICS];
+    size_t mnemonicLengths[MAX_MNEMONICS];
+    uint16_t command;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+static const char *getKeyword(const Node &node) {
+    return g_commands[node.command].pattern + node.keywordOffset;
+}
+
+static uint16_t allocNode() {
+    if (g_numNodes == MAX_NODES) {
+        return NONE;
+    }
+
+    Node &node = g_nodes[g_numNodes];
+    node.firstChild = NONE;
+    node.nextSibling = NONE;
+    node.firstCommand = NONE;
+    node.firstQueryCommand = NONE;
+
+    return g_numNodes++;
+}
+
+static uint16_t addChild(uint16_t parentIndex, uint16_t command, int keywordOffset, int keywordLength, bool optional) {
+    const char *keyword = g_commands[command].pattern + keywordOffset;
+
+    uint8_t flags = optional ? FLAG_OPTIONAL : 0;
+    if (keyword[keywordLength - 1] == '#') {
+        flags |= FLAG_NUMERIC_SUFFIX;
+        keywordLength--;
+    }
+
+    for (uint16_t childIndex = g_nodes[parentIndex].firstChild; childIndex != NONE; childIndex = g_nodes[childIndex].nextSibling) {
+        Node &child = g_nodes[childIndex];
+        if (child.flags == flags && child.keywordLength == keywordLength && strncmp(getKeyword(child), keyword, keywordLength) == 0) {
+            return childIndex;
+        }
+    }
+
+    if (keywordOffset > 255 || keywordLength > 255) {
+        return NONE;
+    }
+
+    uint16_t childIndex = allocNode();
+    if (childIndex == NONE) {
+        return NONE;
+    }
+
+    Node &child = g_nodes[childIndex];
+    child.command = command;
+    child.keywordOffset = (uint8_t)keywordOffset;
+    child.keywordLength = (uint8_t)keywordLength;
+    child.shortLength = 0;
+    while (child.shortLength < keywordLength && !islower((unsigned char)keyword[child.shortLength])) {
+        child.shortLength++;
+    }
+    child.flags = flags;
+
+    Node &parent = g_nodes[parentIndex];
+    child.nextSibling = parent.firstChild;
+    parent.firstChild = childIndex;
+
+    return childIndex;
+}
+
+static bool addCommand(uint16_t command) {
+    const char *pattern = g_commands[command].pattern;
+    int len = strlen(pattern);
+
+    bool isQuery = len > 0 && pattern[len - 1] == '?';
+    if (isQuery) {
+        len--;
+    }
+
+    uint16_t nodeIndex = 0;
+    int depth = 0;
+
+    for (int pos = 0; pos < len;) {
+        char c = pattern[pos];
+        if (c == '[') {
+            depth++;
+            pos++;
+        } else if (c == ']') {
+            depth--;
+            pos++;
+        } else if (c == ':') {
+            pos++;
+        } else {
+            int start = pos;
+            while (pos < len && pattern[pos] != ':' && pattern[pos] != '[' && pattern[pos] != ']') {
+                pos++;
+            }
+            nodeIndex = addChild(nodeIndex, command, start, pos - start, depth > 0);
+            if (nodeIndex == NONE) {
+                return false;
+            }
+        }
+    }
+
+    // append, so the list stays in table order
+    uint16_t *next = isQuery ? &g_nodes[nodeIndex].firstQueryCommand : &g_nodes[nodeIndex].firstCommand;
+    while (*next != NONE) {
+        next = &g_nextCommand[*next];
+    }
+    *next = command;
+    g_nextCommand[command] = NONE;
+
+    return true;
+}
+
+bool build(const scpi_command_t *commands) {
+    g_commands = commands;
+    g_numNodes = 0;
+    allocNode(); // root
+
+    for (int i = 0; commands[i].pattern != NULL; i++) {
+        if (i == MAX_COMMANDS || !addCommand(i)) {
+            DebugTrace("SCPI command index doesn't fit, using linear search\n");
+            g_commands = nullptr;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static bool matchForm(const char *keyword, size_t keywordLength, bool numericSuffix, const char *str, size_t len) {
+    if (numericSuffix ? len < keywordLength : len != keywordLength) {
+        return false;
+    }
+
+    for (size_t i = 0; i < keywordLength; i++) {
+        if (toupper((unsigned char)keyword[i]) != toupper((unsigned char)str[i])) {
+            return false;
+        }
+    }
+
+    for (size_t i = keywordLength; i < len; i++) {
+        if (!isdigit((unsigned char)str[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool matchKeyword(const Node &node, const char *str, size_t len) {
+    const char *keyword = getKeyword(node);
+    bool numericSuffix = (node.flags & FLAG_NUMERIC_SUFFIX) != 0;
+    return matchForm(keyword, node.keywordLength, numericSuffix, str, len) ||
+        (node.shortLength != node.keywordLength && matchForm(keyword, node.shortLength, numericSuffix, str, len));
+}
+
+static void search(Lookup &lookup, uint16_t nodeIndex, int mnemonicIndex) {
+    Node &node = g_nodes[nodeIndex];
+
+    if (mnemonicIndex == lookup.numMnemonics) {
+        uint16_t command = lookup.isQuery ? node.firstQueryCommand : node.firstCommand;
+        for (; command != NONE && command < lookup.command; command = g_nextCommand[command]) {
+            if (SCPI_Match(g_commands[command].pattern, lookup.header, lookup.len)) {
+                lookup.command = command;
+                break;
+            }
+        }
+    }
+
+    for (uint16_t childIndex = node.firstChild; childIndex != NONE; childIndex = g_nodes[childIndex].nextSibling) {
+        Node &child = g_nodes[childIndex];
+
+        if (mnemonicIndex < lookup.numMnemonics && matchKeyword(child, lookup.mnemonics[mnemonicIndex], lookup.mnemonicLengths[mnemonicIndex])) {
+            search(lookup, childIndex, mnemonicIndex + 1);
+        }
+
+        if (child.flags & FLAG_OPTIONAL) {
+            search(lookup, childIndex, mnemonicIndex);
+        }
+    }
+}
+
+static bool splitHeader(Lookup &lookup) {
+    const char *p = lookup.header;
+    const char *end = lookup.header + lookup.len;
+
+    lookup.isQuery = p != end && end[-1] == '?';
+    if (lookup.isQuery) {
+        end--;
+    }
+
+    if (p != end && *p == ':') {
+        p++;
+    }
+
+    lookup.numMnemonics = 0;
+    while (p != end) {
+        if (lookup.numMnemonics == MAX_MNEMONICS) {
+            return false;
+        }
+
+        const char *mnemonic = p;
+        while (p != end && *p != ':') {
+            p++;
+        }
+        if (p == mnemonic) {
+            return false;
+        }
+
+        lookup.mnemonics[lookup.numMnemonics] = mnemonic;
+        lookup.mnemonicLengths[lookup.numMnemonics] = p - mnemonic;
+        lookup.numMnemonics++;
+
+        if (p != end) {
+            p++;
+            if (p == end) {
+                return false;
+            }
+        }
+    }
+
+    return lookup.numMnemonics > 0;
+}
+
+static const scpi_command_t *linearSearch(const scpi_command_t *commands, const char *header, size_t len) {
+    for (int i = 0; commands[i].pattern != NULL; i++) {
+        if (SCPI_Match(commands[i].pattern, header, len)) {
+            return &commands[i];
+        }
+    }
+    return nullptr;
+}
+
+const scpi_command_t *findCommand(scpi_t *context, const char *header, size_t len) {
+    if (!g_commands) {
+        return linearSearch(context->cmdlist, header, len);
+    }
+
+    Lookup lookup;
+    lookup.header = header;
+    lookup.len = len;
+    lookup.command = NONE;
+
+    if (splitHeader(lookup)) {
+        search(lookup, 0, 0);
+        if (lookup.command != NONE) {
+            return &g_commands[lookup.command];
+        }
+    }
+
+    // header not in the index (most probably undefined header error),
+    // confirm with the linear search to behave exactly as before
+    return linearSearch(g_commands, header, len);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+
+static const size_t MAX_HEADER_LENGTH = 64;
+
+// shortest header for the pattern: mandatory keywords in short form, with numeric suffix 1
+static void getShortestHeader(const char *pattern, char *header) {
+    size_t len = 0;
+    int depth = 0;
+
+    for (const char *p = pattern; *p && len < MAX_HEADER_LENGTH - 3;) {
+        if (*p == '[') {
+            depth++;
+            p++;
+        } else if (*p == ']') {
+            depth--;
+            p++;
+        } else if (*p == ':' || *p == '?') {
+            p++;
+        } else {
+            const char *keyword = p;
+            while (*p && *p != ':' && *p != '[' && *p != ']' && *p != '?') {
+                p++;
+            }
+            if (depth == 0) {
+                if (len > 0) {
+                    header[len++] = ':';
+                }
+                for (const char *q = keyword; q < p && *q != '#' && !islower((unsigned char)*q) && len < MAX_HEADER_LENGTH - 3; q++) {
+                    header[len++] = *q;
+                }
+                if (p[-1] == '#') {
+                    header[len++] = '1';
+                }
+            }
+        }
+    }
+
+    size_t patternLength = strlen(pattern);
+    if (patternLength > 0 && pattern[patternLength - 1] == '?') {
+        header[len++] = '?';
+    }
+
+    header[len] = 0;
+}
+
+void benchmark(uint32_t numIterations, float &linearHeadersPerSecond, float &indexedHeadersPerSecond, uint32_t &numMismatches) {
+    linearHeadersPerSecond = 0;
+    indexedHeadersPerSecond = 0;
+    numMismatches = 0;
+
+    if (!g_commands) {
+        return;
+    }
+
+    int numCommands = 0;
+    while (g_commands[numCommands].pattern != NULL) {
+        numCommands++;
+    }
+
+    char *headers = (char *)malloc(numCommands * MAX_HEADER_LENGTH);
+    if (!headers) {
+        return;
+    }
+
+    for (int i = 0; i < numCommands; i++) {
+        char *header = headers + i * MAX_HEADER_LENGTH;
+        getShortestHeader(g_commands[i].pattern, header);
+
+        size_t len = strlen(header);
+        if (linearSearch(g_commands, header, len) != findCommand(nullptr, header, len)) {
+            numMismatches++;
+        }
+    }
+
+    const scpi_command_t * volatile result;
+
+    uint32_t start = micros();
+    for (uint32_t iteration = 0; iteration < numIterations; iteration++) {
+        for (int i = 0; i < numCommands; i++) {
+            const char *header = headers + i * MAX_HEADER_LENGTH;
+            result = linearSearch(g_commands, header, strlen(header));
+        }
+    }
+    uint32_t linearDuration = micros() - start;
+
+    start = micros();
+    for (uint32_t iteration = 0; iteration < numIterations; iteration++) {
+        for (int i = 0; i < numCommands; i++) {
+            const char *header = headers + i * MAX_HEADER_LENGTH;
+            result = findCommand(nullptr, header, strlen(header));
+        }
+    }
+    uint32_t indexedDuration = micros() - start;
+
+    (void)result;
+
+    free(headers);
+
+    float numHeaders = 1.0f * numIterations * numCommands;
+    linearHeadersPerSecond = numHeaders * 1E6f / MAX(linearDuration, 1);
+    indexedHeadersPerSecond = numHeaders * 1E6f / MAX(indexedDuration, 1);
+}
+
+#endif
+
+} // namespace command_index
+} // namespace scpi
+} // namespace psu
+} // namespace eez
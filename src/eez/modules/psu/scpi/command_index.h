@@ -0,0 +1,44 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <scpi/scpi.h>
+
+namespace eez {
+namespace psu {
+namespace scpi {
+namespace command_index {
+
+// Builds a trie over the mnemonics of the command patterns, so the command header
+// can be resolved without matching it against every pattern in the commands table.
+// Returns false if index doesn't fit into SCPI_COMMAND_INDEX_MEMORY.
+bool build(const scpi_command_t *commands);
+
+// scpi_t::find_command implementation, gives the same command as the linear search.
+const scpi_command_t *findCommand(scpi_t *context, const char *header, size_t len);
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+// Resolves a header generated from every command pattern with linear search and with the index.
+void benchmark(uint32_t numIterations, float &linearHeadersPerSecond, float &indexedHeadersPerSecond, uint32_t &numMismatches);
+#endif
+
+} // namespace command_index
+} // namespace scpi
+} // namespace psu
+} // namespace eez
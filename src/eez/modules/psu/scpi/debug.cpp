@@ -453,6 +453,139 @@ scpi_result_t scpi_cmd_debugEvent(scpi_t *context) {
     return SCPI_RES_OK;
 }
 
+#ifdef DEBUG
+static bool getProbeParam(scpi_t *context, DebugProbe *&probe) {
+    const char *name;
+    size_t nameLength;
+    if (!SCPI_ParamCharacters(context, &name, &nameLength, true)) {
+        return false;
+    }
+
+    char nameStr[64];
+    if (nameLength >= sizeof(nameStr)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+        return false;
+    }
+    memcpy(nameStr, name, nameLength);
+    nameStr[nameLength] = 0;
+
+    probe = DebugProbe::find(nameStr);
+    if (!probe) {
+        SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+        return false;
+    }
+
+    return true;
+}
+#endif // DEBUG
+
+scpi_result_t scpi_cmd_debugProbeCatalogQ(scpi_t *context) {
+    // TODO migrate to generic firmware
+#ifdef DEBUG
+    for (DebugProbe *probe = DebugProbe::getFirst(); probe; probe = probe->getNext()) {
+        SCPI_ResultText(context, probe->name());
+    }
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif // DEBUG
+}
+
+scpi_result_t scpi_cmd_debugProbeQ(scpi_t *context) {
+    // TODO migrate to generic firmware
+#ifdef DEBUG
+    DebugProbe *probe;
+    if (!getProbeParam(context, probe)) {
+        return SCPI_RES_ERR;
+    }
+
+    // count, min, avg and max duration in microseconds
+    SCPI_ResultUInt32(context, probe->getCount());
+    SCPI_ResultUInt32(context, probe->getMin());
+    SCPI_ResultUInt32(context, probe->getAverage());
+    SCPI_ResultUInt32(context, probe->getMax());
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif // DEBUG
+}
+
+scpi_result_t scpi_cmd_debugProbeHistogramQ(scpi_t *context) {
+    // TODO migrate to generic firmware
+#ifdef DEBUG
+    DebugProbe *probe;
+    if (!getProbeParam(context, probe)) {
+        return SCPI_RES_ERR;
+    }
+
+    for (int i = 0; i < eez::debug::DEBUG_PROBE_NUM_HISTOGRAM_BUCKETS; i++) {
+        SCPI_ResultUInt32(context, probe->getHistogramBucket(i));
+    }
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif // DEBUG
+}
+
+scpi_result_t scpi_cmd_debugProbeReset(scpi_t *context) {
+    // TODO migrate to generic firmware
+#ifdef DEBUG
+    eez::debug::resetProbes();
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif // DEBUG
+}
+
+scpi_result_t scpi_cmd_debugTraceStart(scpi_t *context) {
+    // TODO migrate to generic firmware
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+    const char *filePath;
+    size_t filePathLength;
+    if (!SCPI_ParamCharacters(context, &filePath, &filePathLength, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    char filePathStr[MAX_PATH_LENGTH + 1];
+    if (filePathLength > MAX_PATH_LENGTH) {
+        SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+        return SCPI_RES_ERR;
+    }
+    memcpy(filePathStr, filePath, filePathLength);
+    filePathStr[filePathLength] = 0;
+
+    if (!eez::debug::startTrace(filePathStr)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_debugTraceStop(scpi_t *context) {
+    // TODO migrate to generic firmware
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+    eez::debug::stopTrace();
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
 } // namespace scpi
 } // namespace psu
 } // namespace eez
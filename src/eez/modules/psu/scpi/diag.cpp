@@ -25,6 +25,7 @@
 #include <eez/modules/psu/init.h>
 #include <eez/modules/psu/calibration.h>
 #include <eez/modules/psu/devices.h>
+#include <eez/modules/psu/scheduler.h>
 #include <eez/modules/psu/scpi/psu.h>
 #include <eez/modules/psu/temperature.h>
 
@@ -405,6 +406,35 @@ scpi_result_t scpi_cmd_diagnosticInformationFanQ(scpi_t *context) {
     return SCPI_RES_OK;
 }
 
+// One line for each PSU task, times are in microseconds.
+scpi_result_t scpi_cmd_diagnosticInformationSchedulerQ(scpi_t *context) {
+    // TODO migrate to generic firmware
+    char buffer[256];
+
+    for (int i = 0; i < scheduler::getNumTasks(); i++) {
+        const scheduler::Task &task = scheduler::getTask(i);
+        const scheduler::TaskStatistics &statistics = task.statistics;
+
+        uint32_t avgJitter = statistics.numRuns > 0 ? (uint32_t)(statistics.totalJitter / statistics.numRuns) : 0;
+
+        sprintf(buffer, "%s: period=%u, budget=%u, runs=%u, jitter_avg=%u, jitter_max=%u, duration_max=%u, overruns=%u, missed=%u",
+            task.name, (unsigned)task.period, (unsigned)task.budget, (unsigned)statistics.numRuns,
+            (unsigned)avgJitter, (unsigned)statistics.maxJitter, (unsigned)statistics.maxDuration,
+            (unsigned)statistics.numOverruns, (unsigned)statistics.numMissedPeriods);
+
+        SCPI_ResultText(context, buffer);
+    }
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_diagnosticInformationSchedulerReset(scpi_t *context) {
+    // TODO migrate to generic firmware
+    scheduler::resetStatistics();
+
+    return SCPI_RES_OK;
+}
+
 static uint8_t g_ioexpRegisters[CH_MAX][32];
 static uint8_t g_adcRegisters[CH_MAX][4];
 
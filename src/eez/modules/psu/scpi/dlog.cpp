@@ -20,6 +20,7 @@
 
 #include <eez/modules/psu/scpi/psu.h>
 #if OPTION_SD_CARD
+#include <eez/memory.h>
 #include <eez/modules/psu/dlog_record.h>
 #endif
 
@@ -308,6 +309,39 @@ scpi_result_t scpi_cmd_senseDlogTimeQ(scpi_t *context) {
 #endif
 }
 
+scpi_result_t scpi_cmd_senseDlogCompression(scpi_t *context) {
+    // TODO migrate to generic firmware
+#if OPTION_SD_CARD
+    if (!dlog_record::isIdle()) {
+        SCPI_ErrorPush(context, SCPI_ERROR_CANNOT_CHANGE_TRANSIENT_TRIGGER);
+        return SCPI_RES_ERR;
+    }
+
+    bool enable;
+    if (!SCPI_ParamBool(context, &enable, TRUE)) {
+        return SCPI_RES_ERR;
+    }
+
+    dlog_record::g_parameters.compress = enable;
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_senseDlogCompressionQ(scpi_t *context) {
+    // TODO migrate to generic firmware
+#if OPTION_SD_CARD
+    SCPI_ResultBool(context, dlog_record::g_parameters.compress);
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
 scpi_result_t scpi_cmd_senseDlogTraceComment(scpi_t *context) {
 #if OPTION_SD_CARD
     if (!dlog_record::isIdle()) {
@@ -989,6 +1023,72 @@ scpi_result_t scpi_cmd_senseDlogTraceData(scpi_t *context) {
 #endif
 }
 
+scpi_result_t scpi_cmd_senseDlogStatisticsQ(scpi_t *context) {
+    // TODO migrate to generic firmware
+#if OPTION_SD_CARD
+    SCPI_ResultUInt32(context, dlog_record::g_fileWriterStatistics.bytesWritten);
+    SCPI_ResultUInt32(context, dlog_record::g_fileWriterStatistics.numFlushes);
+    SCPI_ResultUInt32(context, dlog_record::g_fileWriterStatistics.numSyncs);
+    SCPI_ResultFloat(context, dlog_record::g_fileWriterStatistics.maxFlushDuration / 1000000.0f);
+    SCPI_ResultUInt32(context, dlog_record::g_fileWriterStatistics.bufferHighWaterMark);
+    SCPI_ResultUInt32(context, dlog_record::g_fileWriterStatistics.numOverruns);
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+// SENSe:DLOG:DATA? <from row>[,<max rows>]
+// Returns index of the first returned row, number of dropped rows, number of columns
+// and the rows (in FORMat:DATA format). Client polls with <from row> set to
+// first row index + number of returned rows from the previous response.
+scpi_result_t scpi_cmd_senseDlogDataQ(scpi_t *context) {
+    // TODO migrate to generic firmware
+#if OPTION_SD_CARD
+    int32_t fromRowIndex;
+    if (!SCPI_ParamInt32(context, &fromRowIndex, true)) {
+        return SCPI_RES_ERR;
+    }
+    if (fromRowIndex < 0) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    uint32_t numColumns = dlog_record::g_recording.parameters.numYAxes;
+    uint32_t maxRows = numColumns > 0 ? DLOG_STREAM_BUFFER_SIZE / (numColumns * sizeof(float)) : 0;
+
+    int32_t maxRowsParam;
+    if (SCPI_ParamInt32(context, &maxRowsParam, false)) {
+        if (maxRowsParam <= 0) {
+            SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+            return SCPI_RES_ERR;
+        }
+        if ((uint32_t)maxRowsParam < maxRows) {
+            maxRows = maxRowsParam;
+        }
+    } else if (SCPI_ParamErrorOccurred(context)) {
+        return SCPI_RES_ERR;
+    }
+
+    float *rows = (float *)DLOG_STREAM_BUFFER;
+    uint32_t firstRowIndex;
+    uint32_t numRows;
+    uint32_t numDroppedRows;
+    dlog_record::readRows(fromRowIndex, maxRows, rows, firstRowIndex, numRows, numDroppedRows);
+
+    SCPI_ResultUInt32(context, firstRowIndex);
+    SCPI_ResultUInt32(context, numDroppedRows);
+    SCPI_ResultUInt32(context, numColumns);
+    SCPI_ResultArrayFloat(context, rows, numRows * numColumns, getArrayFormat(context));
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
 
 } // namespace scpi
 } // namespace psu
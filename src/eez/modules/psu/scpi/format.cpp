@@ -0,0 +1,105 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <eez/modules/psu/psu.h>
+
+#include <eez/modules/psu/scpi/psu.h>
+
+namespace eez {
+namespace psu {
+namespace scpi {
+
+static scpi_choice_def_t dataFormatChoice[] = {
+    { "ASCii", 0 }, { "REAL", 1 }, SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+static scpi_choice_def_t byteOrderChoice[] = {
+    { "NORMal", 0 }, { "SWAPped", 1 }, SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+scpi_array_format_t getArrayFormat(scpi_t *context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+    if (!psu_context->isBinaryDataFormat) {
+        return SCPI_FORMAT_ASCII;
+    }
+    return psu_context->isSwappedByteOrder ? SCPI_FORMAT_SWAPPED : SCPI_FORMAT_NORMAL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+scpi_result_t scpi_cmd_formatData(scpi_t *context) {
+    // TODO migrate to generic firmware
+    int32_t format;
+    if (!SCPI_ParamChoice(context, dataFormatChoice, &format, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    // only 32-bit floats are supported for REAL
+    int32_t length;
+    if (SCPI_ParamInt(context, &length, false)) {
+        if (format == 0 || length != 32) {
+            SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+            return SCPI_RES_ERR;
+        }
+    } else if (SCPI_ParamErrorOccurred(context)) {
+        return SCPI_RES_ERR;
+    }
+
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+    psu_context->isBinaryDataFormat = format == 1;
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_formatDataQ(scpi_t *context) {
+    // TODO migrate to generic firmware
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+    if (psu_context->isBinaryDataFormat) {
+        SCPI_ResultMnemonic(context, "REAL");
+        SCPI_ResultInt(context, 32);
+    } else {
+        SCPI_ResultMnemonic(context, "ASC");
+    }
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_formatBorder(scpi_t *context) {
+    // TODO migrate to generic firmware
+    int32_t byteOrder;
+    if (!SCPI_ParamChoice(context, byteOrderChoice, &byteOrder, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+    psu_context->isSwappedByteOrder = byteOrder == 1;
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_formatBorderQ(scpi_t *context) {
+    // TODO migrate to generic firmware
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+    resultChoiceName(context, byteOrderChoice, psu_context->isSwappedByteOrder ? 1 : 0);
+    return SCPI_RES_OK;
+}
+
+} // namespace scpi
+} // namespace psu
+} // namespace eez
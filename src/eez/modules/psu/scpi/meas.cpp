@@ -28,6 +28,89 @@ namespace scpi {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Channels from the list of channel parameters or, if none is given, all the channels which are OK.
+static bool getChannelList(scpi_t *context, Channel **channels, int &numChannels) {
+    numChannels = 0;
+
+    while (true) {
+        int32_t channelIndex;
+        if (!SCPI_ParamChoice(context, channel_choice, &channelIndex, false)) {
+            if (SCPI_ParamErrorOccurred(context)) {
+                return false;
+            }
+            break;
+        }
+        channelIndex--;
+
+        if (!check_channel(context, channelIndex)) {
+            return false;
+        }
+
+        if (numChannels == CH_MAX) {
+            SCPI_ErrorPush(context, SCPI_ERROR_TOO_MUCH_DATA);
+            return false;
+        }
+
+        channels[numChannels++] = &Channel::get(channelIndex);
+    }
+
+    if (numChannels == 0) {
+        for (int i = 0; i < CH_NUM; i++) {
+            Channel &channel = Channel::get(i);
+            if (channel.isOk()) {
+                channels[numChannels++] = &channel;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Voltage, current and power for each channel, and with extended also voltage and current set
+// values and mode (0 - CV, 1 - CC, 2 - UR). In REAL format values are sent as one block of floats.
+static scpi_result_t measureAll(scpi_t *context, bool extended) {
+    Channel *channels[CH_MAX];
+    int numChannels;
+    if (!getChannelList(context, channels, numChannels)) {
+        return SCPI_RES_ERR;
+    }
+
+    static const int MAX_VALUES_PER_CHANNEL = 6;
+    float values[CH_MAX * MAX_VALUES_PER_CHANNEL];
+    int numValues = 0;
+
+    for (int i = 0; i < numChannels; i++) {
+        Channel &channel = *channels[i];
+
+        float uMon = channel_dispatcher::getUMonLast(channel);
+        float iMon = channel_dispatcher::getIMonLast(channel);
+
+        values[numValues++] = uMon;
+        values[numValues++] = iMon;
+        values[numValues++] = uMon * iMon;
+
+        if (extended) {
+            values[numValues++] = channel_dispatcher::getUSet(channel);
+            values[numValues++] = channel_dispatcher::getISet(channel);
+            values[numValues++] = channel.isCvMode() ? 0.0f : channel.isCcMode() ? 1.0f : 2.0f;
+        }
+    }
+
+    SCPI_ResultArrayFloat(context, values, numValues, getArrayFormat(context));
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_measureScalarAllDcQ(scpi_t *context) {
+    // TODO migrate to generic firmware
+    return measureAll(context, false);
+}
+
+scpi_result_t scpi_cmd_measureScalarAllExtendedQ(scpi_t *context) {
+    // TODO migrate to generic firmware
+    return measureAll(context, true);
+}
+
 scpi_result_t scpi_cmd_measureScalarCurrentDcQ(scpi_t *context) {
     // TODO migrate to generic firmware
     Channel *channel = param_channel(context);
@@ -35,9 +118,11 @@ scpi_result_t scpi_cmd_measureScalarCurrentDcQ(scpi_t *context) {
         return SCPI_RES_ERR;
     }
 
-    char buffer[256] = { 0 };
-    strcatCurrent(buffer, channel_dispatcher::getIMonLast(*channel));
-    SCPI_ResultCharacters(context, buffer, strlen(buffer));
+    float value = channel_dispatcher::getIMonLast(*channel);
+
+    char buffer[32];
+    char *end = formatFloatPrec(buffer, value, channel_dispatcher::getValuePrecision(*channel, UNIT_AMPER, value), "A");
+    SCPI_ResultCharacters(context, buffer, end - buffer);
 
     return SCPI_RES_OK;
 }
@@ -49,9 +134,11 @@ scpi_result_t scpi_cmd_measureScalarPowerDcQ(scpi_t *context) {
         return SCPI_RES_ERR;
     }
 
-    char buffer[256] = { 0 };
-    strcatFloat(buffer, channel_dispatcher::getUMonLast(*channel) * channel_dispatcher::getIMonLast(*channel));
-    SCPI_ResultCharacters(context, buffer, strlen(buffer));
+    float value = channel_dispatcher::getUMonLast(*channel) * channel_dispatcher::getIMonLast(*channel);
+
+    char buffer[32];
+    char *end = formatFloatPrec(buffer, value, channel_dispatcher::getValuePrecision(*channel, UNIT_WATT, value));
+    SCPI_ResultCharacters(context, buffer, end - buffer);
 
     return SCPI_RES_OK;
 }
@@ -63,9 +150,11 @@ scpi_result_t scpi_cmd_measureScalarVoltageDcQ(scpi_t *context) {
         return SCPI_RES_ERR;
     }
 
-    char buffer[256] = { 0 };
-    strcatFloat(buffer, channel_dispatcher::getUMonLast(*channel));
-    SCPI_ResultCharacters(context, buffer, strlen(buffer));
+    float value = channel_dispatcher::getUMonLast(*channel);
+
+    char buffer[32];
+    char *end = formatFloatPrec(buffer, value, channel_dispatcher::getValuePrecision(*channel, UNIT_VOLT, value));
+    SCPI_ResultCharacters(context, buffer, end - buffer);
 
     return SCPI_RES_OK;
 }
@@ -77,9 +166,9 @@ scpi_result_t scpi_cmd_measureScalarTemperatureThermistorDcQ(scpi_t *context) {
         return SCPI_RES_ERR;
     }
 
-    char buffer[256] = { 0 };
-    strcatFloat(buffer, temperature::sensors[sensor].measure());
-    SCPI_ResultCharacters(context, buffer, strlen(buffer));
+    char buffer[32];
+    char *end = formatFloat(buffer, temperature::sensors[sensor].measure());
+    SCPI_ResultCharacters(context, buffer, end - buffer);
 
     return SCPI_RES_OK;
 }
@@ -703,6 +703,37 @@ scpi_result_t scpi_cmd_mmemoryLoadList(scpi_t *context) {
 #endif
 }
 
+scpi_result_t scpi_cmd_mmemoryLoadListStream(scpi_t *context) {
+    // TODO migrate to generic firmware
+#if OPTION_SD_CARD
+    Channel *channel = set_channel_from_command_number(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!trigger::isIdle()) {
+        SCPI_ErrorPush(context, SCPI_ERROR_CANNOT_CHANGE_TRANSIENT_TRIGGER);
+        return SCPI_RES_ERR;
+    }
+
+    char filePath[MAX_PATH_LENGTH + 1];
+    if (!getFilePath(context, filePath, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    int err;
+    if (!list::loadListStream(channel->channelIndex, filePath, &err)) {
+        SCPI_ErrorPush(context, err);
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
 scpi_result_t scpi_cmd_mmemoryStoreList(scpi_t *context) {
     // TODO migrate to generic firmware
 #if OPTION_SD_CARD
@@ -20,7 +20,9 @@
 
 #include <stdio.h>
 
+#include <eez/debug.h>
 #include <eez/modules/psu/datetime.h>
+#include <eez/modules/psu/scpi/command_index.h>
 #include <eez/modules/psu/scpi/psu.h>
 #include <eez/modules/psu/serial_psu.h>
 #include <eez/scpi/commands.h>
@@ -41,6 +43,25 @@ SCPI_COMMANDS
 #define SCPI_COMMAND(P, C) { P, C },
 static const scpi_command_t scpi_commands[] = { SCPI_COMMANDS SCPI_CMD_LIST_END };
 
+static bool g_isCommandIndexBuilt;
+static bool g_isCommandIndexValid;
+
+#ifdef DEBUG
+// each command is measured with its own probe, named by the command pattern
+static scpi_result_t executeCommand(scpi_t *context, const scpi_command_t *cmd) {
+    eez::debug::DebugProbe *probe = eez::debug::DebugProbe::getDynamic(cmd->pattern);
+    if (!probe) {
+        return cmd->callback(context);
+    }
+
+    probe->start();
+    scpi_result_t result = cmd->callback(context);
+    probe->finish();
+
+    return result;
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void init(scpi_t &scpi_context, scpi_psu_t &scpi_psu_context, scpi_interface_t *interface,
@@ -50,12 +71,27 @@ void init(scpi_t &scpi_context, scpi_psu_t &scpi_psu_context, scpi_interface_t *
               getSerialNumber(), FIRMWARE, input_buffer, input_buffer_length,
               error_queue_data, error_queue_size);
 
+    // all the parser contexts share the same commands table, so index is built only once
+    if (!g_isCommandIndexBuilt) {
+        g_isCommandIndexValid = command_index::build(scpi_commands);
+        g_isCommandIndexBuilt = true;
+    }
+    if (g_isCommandIndexValid) {
+        scpi_context.find_command = command_index::findCommand;
+    }
+
+#ifdef DEBUG
+    scpi_context.execute_command = executeCommand;
+#endif
+
     scpi_psu_context.selected_channel_index = 0;
 #if OPTION_SD_CARD
     scpi_psu_context.currentDirectory[0] = 0;
 #endif
     scpi_psu_context.isBufferOverrun = false;
     scpi_psu_context.bufferOverrunTime = 0;
+    scpi_psu_context.isBinaryDataFormat = false;
+    scpi_psu_context.isSwappedByteOrder = false;
 
     scpi_context.user_context = &scpi_psu_context;
 }
@@ -37,8 +37,13 @@ struct scpi_psu_t {
 #endif
     bool isBufferOverrun;
     uint32_t bufferOverrunTime;
+    // set by FORMat[:DATA] and FORMat:BORDer, used by the queries returning blocks of values
+    bool isBinaryDataFormat;
+    bool isSwappedByteOrder;
 };
 
+scpi_array_format_t getArrayFormat(scpi_t *context);
+
 void init(scpi_t &scpi_context, scpi_psu_t &scpi_psu_context, scpi_interface_t *interface,
           char *input_buffer, size_t input_buffer_length, scpi_error_t *error_queue_data,
           int16_t error_queue_size);
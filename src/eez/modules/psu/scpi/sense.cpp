@@ -163,6 +163,47 @@ scpi_result_t scpi_cmd_senseCurrentDcRangeAutoQ(scpi_t *context) {
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_cmd_senseStatisticsQ(scpi_t *context) {
+    // TODO migrate to generic firmware
+    Channel *channel = param_channel(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    const Channel::Statistics &statistics = channel->statistics;
+
+    SCPI_ResultFloat(context, statistics.getDuration());
+
+    SCPI_ResultUInt32(context, statistics.u.count);
+    SCPI_ResultFloat(context, statistics.u.getMin());
+    SCPI_ResultFloat(context, statistics.u.getMax());
+    SCPI_ResultFloat(context, statistics.u.getMean());
+    SCPI_ResultFloat(context, statistics.u.getRms());
+
+    SCPI_ResultUInt32(context, statistics.i.count);
+    SCPI_ResultFloat(context, statistics.i.getMin());
+    SCPI_ResultFloat(context, statistics.i.getMax());
+    SCPI_ResultFloat(context, statistics.i.getMean());
+    SCPI_ResultFloat(context, statistics.i.getRms());
+
+    SCPI_ResultDouble(context, statistics.ampHours);
+    SCPI_ResultDouble(context, statistics.wattHours);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_senseStatisticsReset(scpi_t *context) {
+    // TODO migrate to generic firmware
+    Channel *channel = param_channel(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    channel->resetStatistics();
+
+    return SCPI_RES_OK;
+}
+
 } // namespace scpi
 } // namespace psu
 } // namespace eez
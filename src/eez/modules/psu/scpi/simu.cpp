@@ -24,6 +24,13 @@
 
 #include <eez/modules/psu/channel_dispatcher.h>
 #include <eez/modules/psu/io_pins.h>
+#if OPTION_SD_CARD
+#include <eez/modules/psu/dlog_record.h>
+#include <eez/modules/psu/list_program.h>
+#include <eez/modules/mcu/display.h>
+#include <eez/modules/psu/scpi/command_index.h>
+#include <eez/modules/psu/util.h>
+#endif
 
 // SIMULATOR SPECIFC CONFIG
 #define SIM_LOAD_MIN 0
@@ -391,6 +398,171 @@ scpi_result_t scpi_cmd_simulatorPin2Q(scpi_t *context) {
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_cmd_simulatorBenchmarkDlogQ(scpi_t *context) {
+#if OPTION_SD_CARD
+    int32_t numRows;
+    if (!SCPI_ParamInt(context, &numRows, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        numRows = 100000;
+    }
+
+    if (numRows <= 0) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    float byteWriterRowsPerSecond;
+    float rowWriterRowsPerSecond;
+    int err = dlog_record::benchmark(numRows, byteWriterRowsPerSecond, rowWriterRowsPerSecond);
+    if (err != SCPI_RES_OK) {
+        SCPI_ErrorPush(context, err);
+        return SCPI_RES_ERR;
+    }
+
+    SCPI_ResultFloat(context, byteWriterRowsPerSecond);
+    SCPI_ResultFloat(context, rowWriterRowsPerSecond);
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_simulatorBenchmarkDrawQ(scpi_t *context) {
+#if OPTION_DISPLAY
+    int32_t numFrames;
+    if (!SCPI_ParamInt(context, &numFrames, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        numFrames = 100;
+    }
+
+    if (numFrames <= 0) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    float fillMpixelsPerSecond;
+    float blitMpixelsPerSecond;
+    float blendMpixelsPerSecond;
+    float textMpixelsPerSecond;
+    if (!mcu::display::benchmark(numFrames, fillMpixelsPerSecond, blitMpixelsPerSecond, blendMpixelsPerSecond, textMpixelsPerSecond)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_OUT_OF_MEMORY_FOR_REQ_OP);
+        return SCPI_RES_ERR;
+    }
+
+    SCPI_ResultFloat(context, fillMpixelsPerSecond);
+    SCPI_ResultFloat(context, blitMpixelsPerSecond);
+    SCPI_ResultFloat(context, blendMpixelsPerSecond);
+    SCPI_ResultFloat(context, textMpixelsPerSecond);
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_simulatorBenchmarkScpiQ(scpi_t *context) {
+    int32_t numIterations;
+    if (!SCPI_ParamInt(context, &numIterations, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        numIterations = 100;
+    }
+
+    if (numIterations <= 0) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    if (!context->find_command) {
+        // index doesn't fit into memory
+        SCPI_ErrorPush(context, SCPI_ERROR_OUT_OF_MEMORY_FOR_REQ_OP);
+        return SCPI_RES_ERR;
+    }
+
+    float linearHeadersPerSecond;
+    float indexedHeadersPerSecond;
+    uint32_t numMismatches;
+    command_index::benchmark(numIterations, linearHeadersPerSecond, indexedHeadersPerSecond, numMismatches);
+
+    SCPI_ResultFloat(context, linearHeadersPerSecond);
+    SCPI_ResultFloat(context, indexedHeadersPerSecond);
+    SCPI_ResultUInt32(context, numMismatches);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_simulatorBenchmarkListQ(scpi_t *context) {
+#if OPTION_SD_CARD
+    int32_t numIterations;
+    if (!SCPI_ParamInt(context, &numIterations, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        numIterations = 10;
+    }
+
+    if (numIterations <= 0) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    float unbufferedLoadTime;
+    float bufferedLoadTime;
+    int err = list::benchmark(numIterations, unbufferedLoadTime, bufferedLoadTime);
+    if (err != SCPI_RES_OK) {
+        SCPI_ErrorPush(context, err);
+        return SCPI_RES_ERR;
+    }
+
+    SCPI_ResultFloat(context, unbufferedLoadTime);
+    SCPI_ResultFloat(context, bufferedLoadTime);
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_simulatorBenchmarkFormatQ(scpi_t *context) {
+    int32_t numIterations;
+    if (!SCPI_ParamInt(context, &numIterations, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        numIterations = 1000;
+    }
+
+    if (numIterations <= 0) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    float guiSprintfValuesPerSecond;
+    float guiFormatValuesPerSecond;
+    float scpiSprintfValuesPerSecond;
+    float scpiFormatValuesPerSecond;
+    uint32_t numMismatches;
+    benchmarkFloatFormat(numIterations, guiSprintfValuesPerSecond, guiFormatValuesPerSecond,
+        scpiSprintfValuesPerSecond, scpiFormatValuesPerSecond, numMismatches);
+
+    SCPI_ResultFloat(context, guiSprintfValuesPerSecond);
+    SCPI_ResultFloat(context, guiFormatValuesPerSecond);
+    SCPI_ResultFloat(context, scpiSprintfValuesPerSecond);
+    SCPI_ResultFloat(context, scpiFormatValuesPerSecond);
+    SCPI_ResultUInt32(context, numMismatches);
+
+    return SCPI_RES_OK;
+}
+
 } // namespace scpi
 } // namespace psu
 } // namespace eez
@@ -496,6 +668,31 @@ scpi_result_t scpi_cmd_simulatorPin2Q(scpi_t *context) {
     return SCPI_RES_ERR;
 }
 
+scpi_result_t scpi_cmd_simulatorBenchmarkDlogQ(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorBenchmarkDrawQ(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorBenchmarkScpiQ(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorBenchmarkListQ(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorBenchmarkFormatQ(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
 } // namespace scpi
 } // namespace psu
 } // namespace eez
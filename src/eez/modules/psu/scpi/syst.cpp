@@ -1605,6 +1605,43 @@ scpi_result_t scpi_cmd_systemCommunicateMqttSettings(scpi_t *context) {
 #endif
 }
 
+#if OPTION_ETHERNET
+static scpi_choice_def_t mqttTelemetryFormatChoice[] = {
+    { "TOPics", mqtt::TELEMETRY_FORMAT_TOPICS },
+    { "JSON", mqtt::TELEMETRY_FORMAT_JSON },
+    { "BINary", mqtt::TELEMETRY_FORMAT_BINARY },
+    SCPI_CHOICE_LIST_END
+};
+#endif
+
+scpi_result_t scpi_cmd_systemCommunicateMqttFormat(scpi_t *context) {
+    // TODO migrate to generic firmware
+#if OPTION_ETHERNET
+    int32_t format;
+    if (!SCPI_ParamChoice(context, mqttTelemetryFormatChoice, &format, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    persist_conf::setMqttTelemetryFormat((uint8_t)format);
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_systemCommunicateMqttFormatQ(scpi_t *context) {
+    // TODO migrate to generic firmware
+#if OPTION_ETHERNET
+    resultChoiceName(context, mqttTelemetryFormatChoice, persist_conf::devConf.mqttTelemetryFormat);
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
 scpi_result_t scpi_cmd_systemCommunicateMqttStateQ(scpi_t *context) {
 #if OPTION_ETHERNET
     SCPI_ResultInt(context, mqtt::g_connectionState);
@@ -18,6 +18,7 @@
 
 #if OPTION_SD_CARD
 
+#include <math.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -199,82 +200,137 @@ bool isSpace(int c) {
 }
 #endif
 
-void matchZeroOrMoreSpaces(File &file) {
+BufferedFileReader::BufferedFileReader(File &file, uint8_t *buffer, uint32_t bufferSize)
+    : m_file(file), m_buffer(buffer), m_bufferSize(bufferSize), m_position(0), m_end(0) {
+}
+
+bool BufferedFileReader::fill() {
+    int n = m_file.read(m_buffer, m_bufferSize);
+    m_position = 0;
+    m_end = n > 0 ? n : 0;
+    return m_end > 0;
+}
+
+void matchZeroOrMoreSpaces(BufferedFileReader &reader) {
     while (true) {
-        int c = file.peek();
+        int c = reader.peek();
         if (!isSpace(c)) {
             return;
         }
-        file.read();
+        reader.read();
     }
 }
 
-bool match(File &file, char c) {
-    matchZeroOrMoreSpaces(file);
-    if (file.peek() == c) {
-        file.read();
+bool match(BufferedFileReader &reader, char c) {
+    matchZeroOrMoreSpaces(reader);
+    if (reader.peek() == c) {
+        reader.read();
         return true;
     }
     return false;
 }
 
-bool match(File &file, float &result) {
-    matchZeroOrMoreSpaces(file);
+static bool isDigit(int c) {
+    return c >= '0' && c <= '9';
+}
 
-    int c = file.peek();
-    if (c == -1) {
-        return false;
-    }
+// float has 24 bit mantissa, more than 9 significant digits doesn't add precision
+#define MAX_SIGNIFICANT_DIGITS 9
 
-    bool isNegative;
-    if (c == '-') {
-        file.read();
-        isNegative = true;
-        c = file.peek();
-    } else {
-        isNegative = false;
-    }
+static const double POW10[] = {
+    1E0, 1E1, 1E2, 1E3, 1E4, 1E5, 1E6, 1E7, 1E8, 1E9, 1E10, 1E11,
+    1E12, 1E13, 1E14, 1E15, 1E16, 1E17, 1E18, 1E19, 1E20, 1E21, 1E22
+};
 
-    bool isFraction = false;
-    float fraction = 1.0;
+// Parses [+|-]digits[.digits][(e|E)[+|-]digits]
+bool match(BufferedFileReader &reader, float &result) {
+    matchZeroOrMoreSpaces(reader);
 
-    long value = -1;
+    int c = reader.peek();
 
-    while (true) {
-        if (c == '.') {
-            if (isFraction) {
-                return false;
-            }
-            isFraction = true;
-        } else if (c >= '0' && c <= '9') {
-            if (value == -1) {
-                value = 0;
-            }
+    bool isNegative = false;
+    if (c == '-' || c == '+') {
+        isNegative = c == '-';
+        reader.read();
+        c = reader.peek();
+    }
 
-            value = value * 10 + c - '0';
+    uint32_t mantissa = 0;
+    int numSignificantDigits = 0;
+    int numDigits = 0;
+    int exponent = 0;
 
-            if (isFraction) {
-                fraction *= 0.1f;
+    for (; isDigit(c); reader.read(), c = reader.peek()) {
+        numDigits++;
+        if (numSignificantDigits < MAX_SIGNIFICANT_DIGITS) {
+            mantissa = mantissa * 10 + c - '0';
+            if (mantissa != 0) {
+                numSignificantDigits++;
             }
         } else {
-            if (value == -1) {
-                return false;
-            }
+            exponent++;
+        }
+    }
 
-            result = (float)value;
-            if (isNegative) {
-                result = -result;
-            }
-            if (isFraction) {
-                result *= fraction;
+    if (c == '.') {
+        reader.read();
+        c = reader.peek();
+
+        for (; isDigit(c); reader.read(), c = reader.peek()) {
+            numDigits++;
+            if (numSignificantDigits < MAX_SIGNIFICANT_DIGITS) {
+                mantissa = mantissa * 10 + c - '0';
+                if (mantissa != 0) {
+                    numSignificantDigits++;
+                }
+                exponent--;
             }
+        }
+    }
 
-            return true;
+    if (numDigits == 0) {
+        return false;
+    }
+
+    if (c == 'e' || c == 'E') {
+        reader.read();
+        c = reader.peek();
+
+        bool isExponentNegative = false;
+        if (c == '-' || c == '+') {
+            isExponentNegative = c == '-';
+            reader.read();
+            c = reader.peek();
+        }
+
+        if (!isDigit(c)) {
+            return false;
+        }
+
+        int explicitExponent = 0;
+        for (; isDigit(c); reader.read(), c = reader.peek()) {
+            if (explicitExponent < 1000) {
+                explicitExponent = explicitExponent * 10 + c - '0';
+            }
         }
 
-        file.read();
-        c = file.peek();
+        exponent += isExponentNegative ? -explicitExponent : explicitExponent;
     }
+
+    double value = mantissa;
+    if (mantissa != 0 && exponent != 0) {
+        if (exponent > 0 && exponent <= 22) {
+            value *= POW10[exponent];
+        } else if (exponent < 0 && exponent >= -22) {
+            value /= POW10[-exponent];
+        } else {
+            value *= pow(10.0, exponent);
+        }
+    }
+
+    result = (float)(isNegative ? -value : value);
+
+    return true;
 }
 
 bool makeParentDir(const char *filePath) {
@@ -333,7 +389,7 @@ bool catalog(const char *dirPath, void *param,
                 type = FILE_TYPE_DLOG;
             } else if (endsWithNoCase(name, ".jpg")) {
                 type = FILE_TYPE_IMAGE;
-            } else if (endsWithNoCase(name, ".py")) {
+            } else if (endsWithNoCase(name, ".py") || endsWithNoCase(name, ".mpy")) {
                 type = FILE_TYPE_MICROPYTHON;
             } else {
                 type = FILE_TYPE_OTHER;
@@ -691,6 +747,10 @@ bool getInfo(uint64_t &usedSpace, uint64_t &freeSpace) {
     return SD.getInfo(usedSpace, freeSpace);
 }
 
+uint32_t getClusterSize() {
+    return SD.getClusterSize();
+}
+
 bool confRead(uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
     int err;
     if (!sd_card::isMounted(&err)) {
@@ -49,9 +49,46 @@ bool isBusy();
 
 void dumpInfo(char *buffer);
 
-void matchZeroOrMoreSpaces(File &file);
-bool match(File &file, float &result);
-bool match(File &file, char c);
+static const uint32_t FILE_READ_BUFFER_SIZE = 512;
+
+// Reads file in blocks of bufferSize bytes, so CSV parsing (list files, ...)
+// doesn't make a file system call for every character.
+class BufferedFileReader {
+  public:
+    BufferedFileReader(File &file, uint8_t *buffer, uint32_t bufferSize);
+
+    // returns -1 at the end of file
+    int peek() {
+        if (m_position == m_end && !fill()) {
+            return -1;
+        }
+        return m_buffer[m_position];
+    }
+
+    int read() {
+        if (m_position == m_end && !fill()) {
+            return -1;
+        }
+        return m_buffer[m_position++];
+    }
+
+    bool available() {
+        return peek() != -1;
+    }
+
+  private:
+    File &m_file;
+    uint8_t *m_buffer;
+    uint32_t m_bufferSize;
+    uint32_t m_position;
+    uint32_t m_end;
+
+    bool fill();
+};
+
+void matchZeroOrMoreSpaces(BufferedFileReader &reader);
+bool match(BufferedFileReader &reader, float &result);
+bool match(BufferedFileReader &reader, char c);
 
 bool makeParentDir(const char *filePath);
 
@@ -73,6 +110,7 @@ bool getDate(const char *filePath, uint8_t &year, uint8_t &month, uint8_t &day,
 bool getTime(const char *filePath, uint8_t &hour, uint8_t &minute, uint8_t &second, int *err);
 
 bool getInfo(uint64_t &usedSpace, uint64_t &freeSpace);
+uint32_t getClusterSize();
 
 } // namespace sd_card
 } // namespace psu
@@ -19,26 +19,26 @@
 #include <eez/modules/psu/psu.h>
 
 #include <math.h>
+#include <stdio.h>
 #include <string.h>
 
+#include <eez/system.h>
+
 #include <eez/modules/psu/channel_dispatcher.h>
 
 namespace eez {
 namespace psu {
 
 void strcatVoltage(char *str, float value) {
-    strcatFloat(str, value);
-    strcat(str, "V");
+    formatFloat(str + strlen(str), value, "V");
 }
 
 void strcatCurrent(char *str, float value) {
-    strcatFloat(str, value);
-    strcat(str, "A");
+    formatFloat(str + strlen(str), value, "A");
 }
 
 void strcatPower(char *str, float value) {
-    strcatFloat(str, value);
-    strcat(str, "W");
+    formatFloat(str + strlen(str), value, "W");
 }
 
 void strcatDuration(char *str, float value) {
@@ -64,5 +64,106 @@ void strcatLoad(char *str, float value) {
     }
 }
 
+#if defined(EEZ_PLATFORM_SIMULATOR)
+
+static const int NUM_BENCHMARK_VALUES = 64;
+
+// number of decimals used by formatFloatPrec for the precision
+static int getNumDecimals(float precision) {
+    int numDecimals = 0;
+    while (precision < 0.999f && numDecimals < 9) {
+        precision *= 10;
+        numDecimals++;
+    }
+    return numDecimals;
+}
+
+static float getValuesPerSecond(uint32_t numValues, uint32_t startTime) {
+    uint32_t duration = micros() - startTime;
+    return numValues * 1000000.0f / (duration > 0 ? duration : 1);
+}
+
+void benchmarkFloatFormat(uint32_t numIterations,
+    float &guiSprintfValuesPerSecond, float &guiFormatValuesPerSecond,
+    float &scpiSprintfValuesPerSecond, float &scpiFormatValuesPerSecond,
+    uint32_t &numMismatches
+) {
+    Channel &channel = Channel::get(0);
+
+    // alternating voltages and currents over the whole channel range,
+    // rounded to the channel resolution as they are when displayed
+    float values[NUM_BENCHMARK_VALUES];
+    float precisions[NUM_BENCHMARK_VALUES];
+    Unit units[NUM_BENCHMARK_VALUES];
+    for (int i = 0; i < NUM_BENCHMARK_VALUES; i++) {
+        units[i] = i % 2 == 0 ? UNIT_VOLT : UNIT_AMPER;
+        float max = units[i] == UNIT_VOLT ? channel.params.U_MAX : channel.params.I_MAX;
+        float value = max * i / NUM_BENCHMARK_VALUES;
+        precisions[i] = channel.getValuePrecision(units[i], value);
+        values[i] = roundPrec(value, precisions[i]);
+    }
+
+    uint32_t numValues = numIterations * NUM_BENCHMARK_VALUES;
+    char text[64];
+    char buffer[256];
+    uint32_t startTime;
+
+    startTime = micros();
+    for (uint32_t iteration = 0; iteration < numIterations; iteration++) {
+        for (int i = 0; i < NUM_BENCHMARK_VALUES; i++) {
+            text[0] = 0;
+            sprintf(text + strlen(text), "%g", values[i]);
+            removeTrailingZerosFromFloat(text);
+            strcat(text, getUnitName(units[i]));
+        }
+    }
+    guiSprintfValuesPerSecond = getValuesPerSecond(numValues, startTime);
+
+    startTime = micros();
+    for (uint32_t iteration = 0; iteration < numIterations; iteration++) {
+        for (int i = 0; i < NUM_BENCHMARK_VALUES; i++) {
+            formatFloat(text, values[i], getUnitName(units[i]));
+        }
+    }
+    guiFormatValuesPerSecond = getValuesPerSecond(numValues, startTime);
+
+    startTime = micros();
+    for (uint32_t iteration = 0; iteration < numIterations; iteration++) {
+        for (int i = 0; i < NUM_BENCHMARK_VALUES; i++) {
+            memset(buffer, 0, sizeof(buffer));
+            sprintf(buffer + strlen(buffer), "%g", values[i]);
+        }
+    }
+    scpiSprintfValuesPerSecond = getValuesPerSecond(numValues, startTime);
+
+    startTime = micros();
+    for (uint32_t iteration = 0; iteration < numIterations; iteration++) {
+        for (int i = 0; i < NUM_BENCHMARK_VALUES; i++) {
+            formatFloatPrec(buffer, values[i], precisions[i]);
+        }
+    }
+    scpiFormatValuesPerSecond = getValuesPerSecond(numValues, startTime);
+
+    // each formatter is compared with the sprintf format it replaces: formatFloat with "%g",
+    // formatFloatPrec with "%.*f" with the same number of decimals (and trailing zeros removed)
+    numMismatches = 0;
+    for (int i = 0; i < NUM_BENCHMARK_VALUES; i++) {
+        sprintf(buffer, "%g", values[i]);
+        formatFloat(text, values[i]);
+        if (strcmp(text, buffer) != 0) {
+            numMismatches++;
+        }
+
+        sprintf(buffer, "%.*f", getNumDecimals(precisions[i]), values[i]);
+        removeTrailingZerosFromFloat(buffer);
+        formatFloatPrec(text, values[i], precisions[i]);
+        if (strcmp(text, buffer) != 0) {
+            numMismatches++;
+        }
+    }
+}
+
+#endif
+
 } // namespace psu
 } // namespace eez
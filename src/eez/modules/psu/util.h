@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 namespace eez {
 namespace psu {
 
@@ -27,5 +29,15 @@ void strcatPower(char *str, float value);
 void strcatDuration(char *str, float value);
 void strcatLoad(char *str, float value);
 
+#if defined(EEZ_PLATFORM_SIMULATOR)
+// Measures values/sec of sprintf("%g") vs. formatFloat/formatFloatPrec on the GUI (value with
+// unit) and SCPI (value with channel precision) paths. Mismatches are values formatted differently
+// by formatFloat than by "%g" and by formatFloatPrec than by "%.*f" with the same number of decimals.
+void benchmarkFloatFormat(uint32_t numIterations,
+    float &guiSprintfValuesPerSecond, float &guiFormatValuesPerSecond,
+    float &scpiSprintfValuesPerSecond, float &scpiFormatValuesPerSecond,
+    uint32_t &numMismatches);
+#endif
+
 } // namespace psu
 } // namespace eez
@@ -21,11 +21,13 @@
 
 #include <eez/mp.h>
 #include <eez/system.h>
+#include <eez/util.h>
 #include <eez/scpi/scpi.h>
 
 #include <eez/libs/sd_fat/sd_fat.h>
 
 #include <eez/modules/psu/psu.h>
+#include <eez/modules/psu/datetime.h>
 #include <eez/modules/psu/event_queue.h>
 #include <eez/modules/psu/scpi/psu.h>
 
@@ -41,6 +43,7 @@
 
 extern "C" {
 #include "py/compile.h"
+#include "py/persistentcode.h"
 #include "py/runtime.h"
 #include "py/gc.h"
 #include "py/stackctrl.h"
@@ -79,6 +82,21 @@ char *g_scriptPath = (char *)MP_BUFFER;
 static char *g_scriptSource = g_scriptPath + MAX_PATH_LENGTH + 1;
 static const size_t MAX_SCRIPT_LENGTH = 32 * 1024;
 static size_t g_scriptSourceLength;
+static bool g_scriptSourceIsBytecode;
+
+// Compiled script is cached next to the source (script.py -> script.mpy). Cache file is
+// a regular .mpy file followed by this trailer, which identifies the source it was compiled from.
+struct ScriptCacheTrailer {
+    uint32_t sourceSize;
+    uint32_t sourceModificationTime;
+    uint32_t magic;
+};
+
+static const uint32_t SCRIPT_CACHE_MAGIC = 0x3159504D; // "MPY1"
+
+static char g_scriptCachePath[MAX_PATH_LENGTH + 1];
+static ScriptCacheTrailer g_scriptCacheTrailer;
+static size_t g_scriptCacheLength;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -153,6 +171,7 @@ bool onSystemStateChanged() {
 }
 
 void oneIter();
+void saveScriptCache(mp_raw_code_t *rawCode);
 
 void mainLoop(const void *) {
 #ifdef __EMSCRIPTEN__
@@ -212,10 +231,17 @@ void oneIter() {
 
 			nlr_buf_t nlr;
 			if (nlr_push(&nlr) == 0) {
-				mp_lexer_t *lex = mp_lexer_new_from_str_len(MP_QSTR__lt_stdin_gt_, g_scriptSource, g_scriptSourceLength, 0);
-				qstr source_name = lex->source_name;
-				mp_parse_tree_t parse_tree = mp_parse(lex, MP_PARSE_FILE_INPUT);
-				mp_obj_t module_fun = mp_compile(&parse_tree, source_name/*, MP_EMIT_OPT_NONE*/, true);
+				mp_raw_code_t *rawCode;
+				if (g_scriptSourceIsBytecode) {
+					rawCode = mp_raw_code_load_mem((const byte *)g_scriptSource, g_scriptSourceLength);
+				} else {
+					mp_lexer_t *lex = mp_lexer_new_from_str_len(MP_QSTR__lt_stdin_gt_, g_scriptSource, g_scriptSourceLength, 0);
+					qstr source_name = lex->source_name;
+					mp_parse_tree_t parse_tree = mp_parse(lex, MP_PARSE_FILE_INPUT);
+					rawCode = mp_compile_to_raw_code(&parse_tree, source_name/*, MP_EMIT_OPT_NONE*/, true);
+					saveScriptCache(rawCode);
+				}
+				mp_obj_t module_fun = mp_make_function_from_raw_code(rawCode, MP_OBJ_NULL, MP_OBJ_NULL);
 				mp_call_function_0(module_fun);
 				nlr_pop();
 			} else {
@@ -234,49 +260,147 @@ void oneIter() {
 
 enum {
     LOAD_SCRIPT,
-    EXECUTE_SCPI
+    EXECUTE_SCPI,
+    SAVE_SCRIPT_CACHE
 };
 
+static void printToScriptCache(void *data, const char *str, size_t len) {
+    // source is already compiled at this point, so its buffer is reused for the .mpy image
+    if (g_scriptCacheLength + len <= MAX_SCRIPT_LENGTH - sizeof(ScriptCacheTrailer)) {
+        memcpy(g_scriptSource + g_scriptCacheLength, str, len);
+    }
+    g_scriptCacheLength += len;
+}
+
+void saveScriptCache(mp_raw_code_t *rawCode) {
+    if (!g_scriptCachePath[0]) {
+        return;
+    }
+
+    g_scriptCacheLength = 0;
+    mp_print_t print = { nullptr, printToScriptCache };
+    mp_raw_code_save(rawCode, &print);
+
+    if (g_scriptCacheLength > MAX_SCRIPT_LENGTH - sizeof(ScriptCacheTrailer)) {
+        return;
+    }
+
+    memcpy(g_scriptSource + g_scriptCacheLength, &g_scriptCacheTrailer, sizeof(ScriptCacheTrailer));
+    g_scriptCacheLength += sizeof(ScriptCacheTrailer);
+
+    // SD card is accessed only from the SCPI thread
+    osMessagePut(scpi::g_scpiMessageQueueId, SCPI_QUEUE_MP_MESSAGE(SAVE_SCRIPT_CACHE, 0), osWaitForever);
+}
+
 void startScript(const char *filePath) {
     g_state = STATE_EXECUTING;
     strcpy(g_scriptPath, filePath);
     osMessagePut(scpi::g_scpiMessageQueueId, SCPI_QUEUE_MP_MESSAGE(LOAD_SCRIPT, 0), osWaitForever);
 }
 
-void loadScript() {
-    uint32_t fileSize;
-    uint32_t bytesRead;
-
+static bool readScriptFile(const char *filePath) {
     eez::File file;
-    if (!file.open(g_scriptPath, FILE_OPEN_EXISTING | FILE_READ)) {
-        goto ErrorNoClose;
+    if (!file.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        return false;
     }
 
-    fileSize = file.size();
+    uint32_t fileSize = file.size();
     if (fileSize > MAX_SCRIPT_LENGTH) {
-        goto Error;
+        file.close();
+        return false;
     }
 
-    bytesRead = file.read(g_scriptSource, fileSize);
+    uint32_t bytesRead = file.read(g_scriptSource, fileSize);
 
     file.close();
 
     if (bytesRead != fileSize) {
-        goto Error;
+        return false;
     }
 
     g_scriptSourceLength = fileSize;
 
+    return true;
+}
+
+static bool initScriptCache() {
+    g_scriptCachePath[0] = 0;
+
+    size_t pathLength = strlen(g_scriptPath);
+    if (!endsWithNoCase(g_scriptPath, ".py") || pathLength + 1 > MAX_PATH_LENGTH) {
+        return false;
+    }
+
+    FileInfo fileInfo;
+    if (fileInfo.fstat(g_scriptPath) != SD_FAT_RESULT_OK) {
+        return false;
+    }
+
+    g_scriptCacheTrailer.sourceSize = fileInfo.getSize();
+    g_scriptCacheTrailer.sourceModificationTime = psu::datetime::makeTime(
+        fileInfo.getModifiedYear(), fileInfo.getModifiedMonth(), fileInfo.getModifiedDay(),
+        fileInfo.getModifiedHour(), fileInfo.getModifiedMinute(), fileInfo.getModifiedSecond());
+    g_scriptCacheTrailer.magic = SCRIPT_CACHE_MAGIC;
+
+    strcpy(g_scriptCachePath, g_scriptPath);
+    strcpy(g_scriptCachePath + pathLength - 2, "mpy");
+
+    return true;
+}
+
+static bool loadScriptCache() {
+    if (!readScriptFile(g_scriptCachePath) || g_scriptSourceLength < 2 + sizeof(ScriptCacheTrailer)) {
+        return false;
+    }
+
+    g_scriptSourceLength -= sizeof(ScriptCacheTrailer);
+
+    if (memcmp(g_scriptSource + g_scriptSourceLength, &g_scriptCacheTrailer, sizeof(ScriptCacheTrailer)) != 0) {
+        return false;
+    }
+
+    if (g_scriptSource[0] != 'M' || g_scriptSource[1] != MPY_VERSION) {
+        return false;
+    }
+
+    return true;
+}
+
+void loadScript() {
+    if (endsWithNoCase(g_scriptPath, ".mpy")) {
+        // precompiled script (mpy-cross), bytecode is much smaller than the source
+        // so this is the way to run programs larger than MAX_SCRIPT_LENGTH of source
+        g_scriptCachePath[0] = 0;
+        g_scriptSourceIsBytecode = true;
+        if (!readScriptFile(g_scriptPath)) {
+            // TODO error report
+            return;
+        }
+    } else if (initScriptCache() && loadScriptCache()) {
+        // source didn't change since the last run, no need to compile and save it again
+        g_scriptCachePath[0] = 0;
+        g_scriptSourceIsBytecode = true;
+    } else {
+        g_scriptSourceIsBytecode = false;
+        if (!readScriptFile(g_scriptPath)) {
+            // TODO error report
+            return;
+        }
+    }
+
     osMessagePut(g_mpMessageQueueId, QUEUE_MESSAGE_START_SCRIPT, osWaitForever);
+}
+
+void writeScriptCache() {
+    eez::File file;
+    if (!file.open(g_scriptCachePath, FILE_CREATE_ALWAYS | FILE_WRITE)) {
+        return;
+    }
 
-    return;
+    // if this write is incomplete, trailer will be missing and cache will be ignored
+    file.write((const uint8_t *)g_scriptSource, g_scriptCacheLength);
 
-Error:
     file.close();
-
-ErrorNoClose:
-    // TODO error report
-    return;
 }
 
 static const char *g_commandOrQueryText;
@@ -284,6 +408,8 @@ static const char *g_commandOrQueryText;
 void onQueueMessage(uint32_t type, uint32_t param) {
     if (type == LOAD_SCRIPT) {
         loadScript();
+    } else if (type == SAVE_SCRIPT_CACHE) {
+        writeScriptCache();
     } else if (type == EXECUTE_SCPI) {
         input(g_scpiContext, (const char *)g_commandOrQueryText, strlen(g_commandOrQueryText));
         input(g_scpiContext, "\r\n", 2);
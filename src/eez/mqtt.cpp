@@ -42,6 +42,7 @@ extern "C" {
 #include <eez/debug.h>
 #include <eez/mqtt.h>
 #include <eez/system.h>
+#include <eez/util.h>
 #include <eez/modules/psu/psu.h>
 #include <eez/modules/psu/trigger.h>
 #include <eez/modules/psu/ethernet.h>
@@ -64,12 +65,19 @@ static const char *PUB_TOPIC_U_SET = "%s/ch/%d/uset";
 static const char *PUB_TOPIC_I_SET = "%s/ch/%d/iset";
 static const char *PUB_TOPIC_U_MON = "%s/ch/%d/umon";
 static const char *PUB_TOPIC_I_MON = "%s/ch/%d/imon";
+static const char *PUB_TOPIC_TELEMETRY_JSON = "%s/telemetry";
+static const char *PUB_TOPIC_TELEMETRY_BINARY = "%s/telemetry/bin";
 
 static const size_t MAX_SUB_TOPIC_LENGTH = 50;
 static const char *SUB_TOPIC = "%s/ch/+/set/+"; // for example: <host_name>/ch/1/set/oe, <host_name>/ch/1/set/u, ch/1/set/i
 
 static const size_t MAX_PAYLOAD_LENGTH = 100;
 
+static const uint8_t TELEMETRY_FRAME_VERSION = 1;
+static const size_t MAX_TELEMETRY_FRAME_LENGTH = 640;
+// ,{"oe":1,"umon":<12>,"imon":<12>,"uset":<12>,"iset":<12>}
+static const size_t MAX_TELEMETRY_JSON_CHANNEL_LENGTH = 96;
+
 static const size_t MAX_TOPIC_LEN = 128;
 static char g_topic[MAX_TOPIC_LEN + 1];
 static const size_t MAX_PAYLOAD_LEN = 128;
@@ -106,6 +114,10 @@ static uint8_t g_lastChannelIndex = 0;
 static uint8_t g_lastValueIndex = 0;
 static bool g_publishing;
 
+static uint8_t g_telemetryFormat = TELEMETRY_FORMAT_TOPICS;
+static uint32_t g_telemetrySequenceNumber;
+static uint32_t g_telemetryTick;
+
 void setState(ConnectionState connectionState);
 
 const char *matchSeparator(const char *p) {
@@ -280,10 +292,14 @@ void incomingPublishCallback(void** unused, struct mqtt_response_publish *publis
 }
 #endif
 
-bool publish(char *topic, char *payload, bool retain) {
+DebugProbeDefine(g_publishProbe, "mqtt:publish");
+
+bool publish(char *topic, const void *payload, size_t payloadLength, bool retain) {
 #if defined(EEZ_PLATFORM_STM32)
 	g_publishing = true;
-    err_t result = mqtt_publish(&g_client, topic, payload, strlen(payload), 0, retain ? 1 : 0, requestCallback, nullptr);
+    DebugProbeStart(g_publishProbe);
+    err_t result = mqtt_publish(&g_client, topic, payload, payloadLength, 0, retain ? 1 : 0, requestCallback, nullptr);
+    DebugProbeFinish(g_publishProbe);
     if (result != ERR_OK) {
     	g_publishing = false;
         if (result != ERR_MEM) {
@@ -297,7 +313,9 @@ bool publish(char *topic, char *payload, bool retain) {
 #endif
 
 #if defined(EEZ_PLATFORM_SIMULATOR)
-    mqtt_publish(&g_client, topic, payload, strlen(payload), MQTT_PUBLISH_QOS_0 | (retain ? MQTT_PUBLISH_RETAIN : 0));
+    DebugProbeStart(g_publishProbe);
+    mqtt_publish(&g_client, topic, (void *)payload, payloadLength, MQTT_PUBLISH_QOS_0 | (retain ? MQTT_PUBLISH_RETAIN : 0));
+    DebugProbeFinish(g_publishProbe);
     if (g_client.error != MQTT_OK) {
         DebugTrace("mqtt error: %s\n", mqtt_error_str(g_client.error));
         return false;
@@ -307,6 +325,10 @@ bool publish(char *topic, char *payload, bool retain) {
     return true;
 }
 
+bool publish(char *topic, char *payload, bool retain) {
+    return publish(topic, payload, strlen(payload), retain);
+}
+
 bool publish(const char *pubTopic, int value) {
     char topic[MAX_PUB_TOPIC_LENGTH + 1];
     sprintf(topic, pubTopic, persist_conf::devConf.ethernetHostName);
@@ -350,11 +372,91 @@ bool publish(int channelIndex, const char *pubTopic, float value) {
     sprintf(topic, pubTopic, persist_conf::devConf.ethernetHostName, channelIndex + 1);
 
     char payload[MAX_PAYLOAD_LENGTH + 1];
-    sprintf(payload, "%g", value);
+    formatFloat(payload, value);
 
     return publish(topic, payload, false);
 }
 
+// All channels in a single frame, so the broker gets one message per period
+// instead of five per channel.
+static char *appendString(char *text, const char *str) {
+    while (*str) {
+        *text++ = *str++;
+    }
+    *text = 0;
+    return text;
+}
+
+bool publishTelemetryFrame(uint32_t timestamp) {
+    char topic[MAX_PUB_TOPIC_LENGTH + 1];
+    // binary frame is written through TelemetryFrameHeader/TelemetryFrameChannel pointers
+    alignas(TelemetryFrameHeader) static char g_frame[MAX_TELEMETRY_FRAME_LENGTH + 1];
+    size_t frameLength;
+
+    if (g_telemetryFormat == TELEMETRY_FORMAT_BINARY) {
+        sprintf(topic, PUB_TOPIC_TELEMETRY_BINARY, persist_conf::devConf.ethernetHostName);
+
+        TelemetryFrameHeader *header = (TelemetryFrameHeader *)g_frame;
+        header->version = TELEMETRY_FRAME_VERSION;
+        header->numChannels = CH_NUM;
+        header->flags = isPowerUp() ? 1 : 0;
+        header->reserved = 0;
+        header->sequenceNumber = g_telemetrySequenceNumber;
+        header->timestamp = timestamp;
+
+        TelemetryFrameChannel *channelFrames = (TelemetryFrameChannel *)(header + 1);
+        for (int i = 0; i < CH_NUM; i++) {
+            Channel &channel = Channel::get(i);
+            TelemetryFrameChannel &channelFrame = channelFrames[i];
+            channelFrame.flags = channel.isOutputEnabled() ? 1 : 0;
+            memset(channelFrame.reserved, 0, sizeof(channelFrame.reserved));
+            channelFrame.uMon = channel_dispatcher::getUMonLast(channel);
+            channelFrame.iMon = channel_dispatcher::getIMonLast(channel);
+            channelFrame.uSet = channel_dispatcher::getUSet(channel);
+            channelFrame.iSet = channel_dispatcher::getISet(channel);
+        }
+
+        frameLength = sizeof(TelemetryFrameHeader) + CH_NUM * sizeof(TelemetryFrameChannel);
+    } else {
+        sprintf(topic, PUB_TOPIC_TELEMETRY_JSON, persist_conf::devConf.ethernetHostName);
+
+        frameLength = snprintf(g_frame, MAX_TELEMETRY_FRAME_LENGTH, "{\"seq\":%u,\"t\":%u,\"pow\":%d,\"ch\":[",
+            (unsigned)g_telemetrySequenceNumber, (unsigned)timestamp, isPowerUp() ? 1 : 0);
+
+        for (int i = 0; i < CH_NUM && frameLength < MAX_TELEMETRY_FRAME_LENGTH; i++) {
+            if (MAX_TELEMETRY_FRAME_LENGTH - frameLength < MAX_TELEMETRY_JSON_CHANNEL_LENGTH) {
+                frameLength = MAX_TELEMETRY_FRAME_LENGTH;
+                break;
+            }
+
+            Channel &channel = Channel::get(i);
+            char *p = g_frame + frameLength;
+            p = appendString(p, i > 0 ? ",{\"oe\":" : "{\"oe\":");
+            p = appendString(p, channel.isOutputEnabled() ? "1" : "0");
+            p = appendString(p, ",\"umon\":");
+            p = formatFloat(p, channel_dispatcher::getUMonLast(channel));
+            p = appendString(p, ",\"imon\":");
+            p = formatFloat(p, channel_dispatcher::getIMonLast(channel));
+            p = appendString(p, ",\"uset\":");
+            p = formatFloat(p, channel_dispatcher::getUSet(channel));
+            p = appendString(p, ",\"iset\":");
+            p = formatFloat(p, channel_dispatcher::getISet(channel), "}");
+            frameLength = p - g_frame;
+        }
+
+        if (frameLength < MAX_TELEMETRY_FRAME_LENGTH) {
+            frameLength += snprintf(g_frame + frameLength, MAX_TELEMETRY_FRAME_LENGTH - frameLength, "]}");
+        }
+
+        if (frameLength >= MAX_TELEMETRY_FRAME_LENGTH) {
+            DebugTrace("mqtt telemetry frame too long\n");
+            return false;
+        }
+    }
+
+    return publish(topic, g_frame, frameLength, false);
+}
+
 const char *getSubTopic() {
     static char g_subTopic[MAX_SUB_TOPIC_LENGTH + 1] = { 0 };
     if (!g_subTopic[0]) {
@@ -383,6 +485,18 @@ const char *getClientId() {
 bool peekEvent(int16_t &eventId);
 bool getEvent(int16_t &eventId);
 
+// everything is published again in TELEMETRY_FORMAT_TOPICS
+void resetChannelStates() {
+    for(int i = 0; i < CH_NUM; i++) {
+        g_channelStates[i].oe = -1;
+        g_channelStates[i].uSet = NAN;
+        g_channelStates[i].iSet = NAN;
+    }
+
+    g_lastChannelIndex = 0;
+    g_lastValueIndex = 0;
+}
+
 void setState(ConnectionState connectionState) {
     if (connectionState == CONNECTION_STATE_CONNECTED) {
 #if defined(EEZ_PLATFORM_STM32)
@@ -394,14 +508,7 @@ void setState(ConnectionState connectionState) {
         mqtt_subscribe(&g_client, getSubTopic(), 0);
 #endif
 
-        for(int i = 0; i < CH_NUM; i++) {
-            g_channelStates[i].oe = -1;
-            g_channelStates[i].uSet = NAN;
-            g_channelStates[i].iSet = NAN;
-        }
-
-        g_lastChannelIndex = 0;
-        g_lastValueIndex = 0;
+        resetChannelStates();
     }
 
     g_connectionState = connectionState;
@@ -436,6 +543,26 @@ void tick(uint32_t tickCount) {
             }
         }
 
+        if (persist_conf::devConf.mqttTelemetryFormat != g_telemetryFormat) {
+            g_telemetryFormat = persist_conf::devConf.mqttTelemetryFormat;
+            resetChannelStates();
+        }
+
+        if (g_telemetryFormat != TELEMETRY_FORMAT_TOPICS) {
+            uint32_t period = (uint32_t)roundf(persist_conf::devConf.mqttPeriod * 1000000);
+            if ((tickCount - g_telemetryTick) >= period) {
+                if (publishTelemetryFrame(millis())) {
+                    g_telemetrySequenceNumber++;
+                    g_telemetryTick = tickCount;
+                }
+            }
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+            mqtt_sync(&g_client);
+#endif
+            return;
+        }
+
         // publish channel state (oe, u_mon, i_mon, u_set, i_set)
         uint8_t channelIndex = g_lastChannelIndex;
         Channel &channel = Channel::get(channelIndex);
@@ -34,6 +34,32 @@ enum ConnectionState {
     CONNECTION_STATE_RECONNECT
 };
 
+enum TelemetryFormat {
+    TELEMETRY_FORMAT_TOPICS, // one topic per value: <host_name>/ch/<n>/oe, umon, imon, uset, iset
+    TELEMETRY_FORMAT_JSON, // one frame per period to <host_name>/telemetry
+    TELEMETRY_FORMAT_BINARY // one frame per period to <host_name>/telemetry/bin
+};
+
+// TELEMETRY_FORMAT_BINARY frame is TelemetryFrameHeader followed by
+// numChannels TelemetryFrameChannel's, little endian.
+struct TelemetryFrameHeader {
+    uint8_t version;
+    uint8_t numChannels;
+    uint8_t flags; // bit 0: power is up
+    uint8_t reserved;
+    uint32_t sequenceNumber;
+    uint32_t timestamp; // milliseconds since boot
+};
+
+struct TelemetryFrameChannel {
+    uint8_t flags; // bit 0: output is enabled
+    uint8_t reserved[3];
+    float uMon;
+    float iMon;
+    float uSet;
+    float iSet;
+};
+
 static const float PERIOD_MIN = 0.1f;
 static const float PERIOD_MAX = 120.0f;
 static const float PERIOD_DEFAULT = 1.0f;
@@ -2,14 +2,214 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 
 #ifdef EEZ_PLATFORM_SIMULATOR_WIN32
 #include <windows.h>
 #else
 #include <sys/time.h>
 #include <time.h>
+#include <errno.h>
 #endif
 
+#ifdef OS_PTHREAD_SYNC
+
+////////////////////////////////////////////////////////////////////////////////
+// Virtual time
+//
+// Time doesn't flow by itself, it jumps to the nearest deadline when every thread is
+// waiting in osDelay, osMessageGet, osMessagePut or osMutexWait. While virtual time is
+// enabled all these primitives are synchronized with g_vtMutex instead of the queue
+// and mutex own pthread mutexes.
+
+#define MAX_VIRTUAL_TIME_THREADS 16
+
+static const uint64_t NO_DEADLINE = UINT64_MAX;
+
+enum VirtualTimeWait {
+    VIRTUAL_TIME_WAIT_SLEEP,
+    VIRTUAL_TIME_WAIT_MESSAGE_GET,
+    VIRTUAL_TIME_WAIT_MESSAGE_PUT,
+    VIRTUAL_TIME_WAIT_MUTEX
+};
+
+struct VirtualTimeThread {
+    void *(*routine)(void *);
+    bool detached; // blocking outside of virtual time primitives, doesn't hold the time
+    bool waiting;
+    VirtualTimeWait wait;
+    osMessageQId queue;
+    Mutex *mutex;
+    uint64_t deadline;
+};
+
+static bool g_vtEnabled;
+static uint64_t g_vtNow; // in microseconds
+static pthread_mutex_t g_vtMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_vtCond = PTHREAD_COND_INITIALIZER;
+static VirtualTimeThread g_vtThreads[MAX_VIRTUAL_TIME_THREADS];
+static int g_vtNumThreads;
+static thread_local VirtualTimeThread *t_vtThread;
+
+// returns nullptr if there is no free slot, g_vtMutex must be locked
+static VirtualTimeThread *allocVirtualTimeThread() {
+    if (g_vtNumThreads == MAX_VIRTUAL_TIME_THREADS) {
+        fprintf(stderr, "virtual time: more than %d threads\n", MAX_VIRTUAL_TIME_THREADS);
+        return nullptr;
+    }
+    VirtualTimeThread *thread = &g_vtThreads[g_vtNumThreads++];
+    memset(thread, 0, sizeof(VirtualTimeThread));
+    return thread;
+}
+
+// threads not created with osThreadCreate (i.e. the main thread) are registered on the first use,
+// returns nullptr if the thread could not be registered
+static VirtualTimeThread *getVirtualTimeThread() {
+    if (!t_vtThread) {
+        t_vtThread = allocVirtualTimeThread();
+    }
+    return t_vtThread;
+}
+
+static void *virtualTimeThreadRoutine(void *arg) {
+    VirtualTimeThread *thread = (VirtualTimeThread *)arg;
+    t_vtThread = thread;
+
+    void *result = thread->routine(0);
+
+    pthread_mutex_lock(&g_vtMutex);
+    thread->detached = true;
+    pthread_cond_broadcast(&g_vtCond);
+    pthread_mutex_unlock(&g_vtMutex);
+
+    return result;
+}
+
+static bool isWaitSatisfied(VirtualTimeThread *thread) {
+    if (thread->wait == VIRTUAL_TIME_WAIT_MESSAGE_GET) {
+        return thread->queue->count > 0;
+    }
+    if (thread->wait == VIRTUAL_TIME_WAIT_MESSAGE_PUT) {
+        return thread->queue->count < thread->queue->numElements;
+    }
+    if (thread->wait == VIRTUAL_TIME_WAIT_MUTEX) {
+        return !thread->mutex->locked;
+    }
+    return false;
+}
+
+static bool isRunnable(VirtualTimeThread *thread) {
+    return !thread->waiting || isWaitSatisfied(thread) || g_vtNow >= thread->deadline;
+}
+
+// moves time to the nearest deadline if no thread can run, g_vtMutex must be locked
+static void advanceVirtualTime() {
+    uint64_t nextDeadline = NO_DEADLINE;
+
+    for (int i = 0; i < g_vtNumThreads; i++) {
+        VirtualTimeThread *thread = &g_vtThreads[i];
+        if (thread->detached) {
+            continue;
+        }
+        if (isRunnable(thread)) {
+            return;
+        }
+        if (thread->deadline < nextDeadline) {
+            nextDeadline = thread->deadline;
+        }
+    }
+
+    if (nextDeadline != NO_DEADLINE) {
+        g_vtNow = nextDeadline;
+        pthread_cond_broadcast(&g_vtCond);
+    }
+}
+
+// returns false on timeout, g_vtMutex must be locked
+static bool waitVirtualTime(VirtualTimeWait wait, osMessageQId queue, Mutex *mutex, uint32_t millisec) {
+    // thread which is not registered waits like the detached one, i.e. it doesn't hold the time
+    VirtualTimeThread unregisteredThread;
+    VirtualTimeThread *thread = getVirtualTimeThread();
+    if (!thread) {
+        memset(&unregisteredThread, 0, sizeof(VirtualTimeThread));
+        unregisteredThread.detached = true;
+        thread = &unregisteredThread;
+    }
+
+    thread->wait = wait;
+    thread->queue = queue;
+    thread->mutex = mutex;
+    thread->deadline = millisec == osWaitForever ? NO_DEADLINE : g_vtNow + millisec * (uint64_t)1000;
+    thread->waiting = true;
+
+    bool result = true;
+    while (!isWaitSatisfied(thread)) {
+        if (g_vtNow >= thread->deadline) {
+            result = false;
+            break;
+        }
+
+        advanceVirtualTime();
+
+        if (g_vtNow < thread->deadline) {
+            pthread_cond_wait(&g_vtCond, &g_vtMutex);
+        }
+    }
+
+    thread->waiting = false;
+
+    return result;
+}
+
+bool osVirtualTimeEnable() {
+    g_vtEnabled = true;
+    return true;
+}
+
+bool osVirtualTimeIsEnabled() {
+    return g_vtEnabled;
+}
+
+uint64_t osVirtualTimeMicros() {
+    pthread_mutex_lock(&g_vtMutex);
+    uint64_t now = g_vtNow;
+    pthread_mutex_unlock(&g_vtMutex);
+    return now;
+}
+
+void osVirtualTimeDetachThread() {
+    if (g_vtEnabled) {
+        pthread_mutex_lock(&g_vtMutex);
+        // thread which could not be registered is not holding the time anyway
+        VirtualTimeThread *thread = getVirtualTimeThread();
+        if (thread) {
+            thread->detached = true;
+            pthread_cond_broadcast(&g_vtCond);
+        }
+        pthread_mutex_unlock(&g_vtMutex);
+    }
+}
+
+#else
+
+bool osVirtualTimeEnable() {
+    // requires blocking primitives to know when all threads are waiting
+    return false;
+}
+
+bool osVirtualTimeIsEnabled() {
+    return false;
+}
+
+uint64_t osVirtualTimeMicros() {
+    return 0;
+}
+
+void osVirtualTimeDetachThread() {
+}
+
+#endif // OS_PTHREAD_SYNC
+
 #ifdef __EMSCRIPTEN__
 #define MAX_THREADS 100
 struct Thread {
@@ -39,6 +239,22 @@ osThreadId osThreadCreate(const osThreadDef_t *thread_def, void *argument) {
     return nullptr;
 #else
     pthread_t thread;
+#ifdef OS_PTHREAD_SYNC
+    if (g_vtEnabled) {
+        // registered before it starts, so time doesn't advance while it is initializing
+        pthread_mutex_lock(&g_vtMutex);
+        VirtualTimeThread *vtThread = allocVirtualTimeThread();
+        if (!vtThread) {
+            pthread_mutex_unlock(&g_vtMutex);
+            return 0;
+        }
+        vtThread->routine = thread_def->pthread;
+        pthread_mutex_unlock(&g_vtMutex);
+
+        pthread_create(&thread, 0, virtualTimeThreadRoutine, vtThread);
+        return thread;
+    }
+#endif
     pthread_create(&thread, 0, thread_def->pthread, 0);
     return thread;
 #endif    
@@ -70,6 +286,17 @@ osStatus osKernelStart(void) {
 }
 
 osStatus osDelay(uint32_t millisec) {
+#ifdef OS_PTHREAD_SYNC
+    if (g_vtEnabled) {
+        // osDelay(0) is used to yield while polling, time must advance meanwhile
+        if (millisec == 0) millisec = 1;
+        pthread_mutex_lock(&g_vtMutex);
+        waitVirtualTime(VIRTUAL_TIME_WAIT_SLEEP, nullptr, nullptr, millisec);
+        pthread_mutex_unlock(&g_vtMutex);
+        return osOK;
+    }
+#endif
+
 #ifdef EEZ_PLATFORM_SIMULATOR_WIN32
     Sleep(millisec);
     return osOK;
@@ -108,6 +335,11 @@ uint32_t osKernelSysTick() {
         return uint32_t(diff % 4294967296);
     }
 #else
+#ifdef OS_PTHREAD_SYNC
+    if (g_vtEnabled) {
+        return uint32_t((osVirtualTimeMicros() / 1000) % 4294967296);
+    }
+#endif
     timeval tv;
     gettimeofday(&tv, NULL);
     uint64_t micros = tv.tv_sec * (uint64_t)1000000 + tv.tv_usec;
@@ -115,6 +347,210 @@ uint32_t osKernelSysTick() {
 #endif    
 }
 
+#ifdef OS_PTHREAD_SYNC
+
+#if defined(__linux__)
+// condition variables are waiting on monotonic clock, so timeouts are not affected by the system time changes
+#define OS_COND_CLOCK CLOCK_MONOTONIC
+#else
+#define OS_COND_CLOCK CLOCK_REALTIME
+#endif
+
+static void getDeadline(clockid_t clockId, uint32_t millisec, timespec &deadline) {
+    clock_gettime(clockId, &deadline);
+    deadline.tv_sec += millisec / 1000;
+    deadline.tv_nsec += (millisec % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+}
+
+static void initCond(pthread_cond_t *cond) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+#if defined(__linux__)
+    pthread_condattr_setclock(&attr, OS_COND_CLOCK);
+#endif
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+// returns false on timeout, mutex must be locked
+static bool waitCond(pthread_cond_t *cond, pthread_mutex_t *mutex, uint32_t millisec, const timespec &deadline) {
+    if (millisec == osWaitForever) {
+        pthread_cond_wait(cond, mutex);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, mutex, &deadline) != ETIMEDOUT;
+}
+
+osMessageQId osMessageCreate(osMessageQId queue_id, osThreadId thread_id) {
+    queue_id->tail = 0;
+    queue_id->head = 0;
+    queue_id->overflow = 0;
+    queue_id->count = 0;
+    pthread_mutex_init(&queue_id->mutex, nullptr);
+    initCond(&queue_id->notEmpty);
+    initCond(&queue_id->notFull);
+    return queue_id;
+}
+
+static osEvent messageGet(osMessageQId queue_id) {
+    uint32_t info = ((uint32_t *)queue_id->data)[queue_id->tail];
+    queue_id->tail = (queue_id->tail + 1) % queue_id->numElements;
+    queue_id->count--;
+
+    return {
+        osEventMessage,
+        info
+    };
+}
+
+static void messagePut(osMessageQId queue_id, uint32_t info) {
+    ((uint32_t *)queue_id->data)[queue_id->head] = info;
+    queue_id->head = (queue_id->head + 1) % queue_id->numElements;
+    queue_id->count++;
+}
+
+osEvent osMessageGet(osMessageQId queue_id, uint32_t millisec) {
+    // same as polling implementation, wait at least 1 ms so the callers loop is not spinning
+    if (millisec == 0) millisec = 1;
+
+    if (g_vtEnabled) {
+        pthread_mutex_lock(&g_vtMutex);
+        if (!waitVirtualTime(VIRTUAL_TIME_WAIT_MESSAGE_GET, queue_id, nullptr, millisec)) {
+            pthread_mutex_unlock(&g_vtMutex);
+            return {
+                osEventTimeout,
+                0
+            };
+        }
+        osEvent event = messageGet(queue_id);
+        pthread_cond_broadcast(&g_vtCond);
+        pthread_mutex_unlock(&g_vtMutex);
+        return event;
+    }
+
+    timespec deadline;
+    if (millisec != osWaitForever) {
+        getDeadline(OS_COND_CLOCK, millisec, deadline);
+    }
+
+    pthread_mutex_lock(&queue_id->mutex);
+
+    while (queue_id->count == 0) {
+        if (!waitCond(&queue_id->notEmpty, &queue_id->mutex, millisec, deadline) && queue_id->count == 0) {
+            pthread_mutex_unlock(&queue_id->mutex);
+            return {
+                osEventTimeout,
+                0
+            };
+        }
+    }
+
+    osEvent event = messageGet(queue_id);
+
+    pthread_cond_signal(&queue_id->notFull);
+    pthread_mutex_unlock(&queue_id->mutex);
+
+    return event;
+}
+
+osStatus osMessagePut(osMessageQId queue_id, uint32_t info, uint32_t millisec) {
+    if (g_vtEnabled) {
+        pthread_mutex_lock(&g_vtMutex);
+        if (!waitVirtualTime(VIRTUAL_TIME_WAIT_MESSAGE_PUT, queue_id, nullptr, millisec)) {
+            pthread_mutex_unlock(&g_vtMutex);
+            return osErrorTimeoutResource;
+        }
+        messagePut(queue_id, info);
+        pthread_cond_broadcast(&g_vtCond);
+        pthread_mutex_unlock(&g_vtMutex);
+        return osOK;
+    }
+
+    timespec deadline;
+    if (millisec != osWaitForever) {
+        getDeadline(OS_COND_CLOCK, millisec, deadline);
+    }
+
+    pthread_mutex_lock(&queue_id->mutex);
+
+    while (queue_id->count == queue_id->numElements) {
+        if (!waitCond(&queue_id->notFull, &queue_id->mutex, millisec, deadline) && queue_id->count == queue_id->numElements) {
+            pthread_mutex_unlock(&queue_id->mutex);
+            return osErrorTimeoutResource;
+        }
+    }
+
+    messagePut(queue_id, info);
+
+    pthread_cond_signal(&queue_id->notEmpty);
+    pthread_mutex_unlock(&queue_id->mutex);
+
+    return osOK;
+}
+
+Mutex *osMutexCreate(Mutex &mutex) {
+    pthread_mutex_init(&mutex.mutex, nullptr);
+    return &mutex;
+}
+
+// Returns osErrorTimeoutResource if the lock was not taken within millisec,
+// caller must not call osMutexRelease then.
+osStatus osMutexWait(Mutex *mutex, uint32_t millisec) {
+    if (g_vtEnabled) {
+        pthread_mutex_lock(&g_vtMutex);
+        if (!waitVirtualTime(VIRTUAL_TIME_WAIT_MUTEX, nullptr, mutex, millisec)) {
+            pthread_mutex_unlock(&g_vtMutex);
+            return osErrorTimeoutResource;
+        }
+        mutex->locked = true;
+        pthread_mutex_unlock(&g_vtMutex);
+        return osOK;
+    }
+
+    if (millisec == osWaitForever) {
+        pthread_mutex_lock(&mutex->mutex);
+    } else {
+#if defined(__linux__)
+        // pthread_mutex_timedlock is always using CLOCK_REALTIME
+        timespec deadline;
+        getDeadline(CLOCK_REALTIME, millisec, deadline);
+        if (pthread_mutex_timedlock(&mutex->mutex, &deadline) != 0) {
+            return osErrorTimeoutResource;
+        }
+#else
+        while (pthread_mutex_trylock(&mutex->mutex) != 0) {
+            if (millisec == 0) {
+                return osErrorTimeoutResource;
+            }
+            osDelay(1);
+            millisec--;
+        }
+#endif
+    }
+
+    mutex->locked = true;
+    return osOK;
+}
+
+void osMutexRelease(Mutex *mutex) {
+    if (g_vtEnabled) {
+        pthread_mutex_lock(&g_vtMutex);
+        mutex->locked = false;
+        pthread_cond_broadcast(&g_vtCond);
+        pthread_mutex_unlock(&g_vtMutex);
+        return;
+    }
+
+    mutex->locked = false;
+    pthread_mutex_unlock(&mutex->mutex);
+}
+
+#else
+
 osMessageQId osMessageCreate(osMessageQId queue_id, osThreadId thread_id) {
     queue_id->tail = 0;
     queue_id->head = 0;
@@ -179,13 +615,22 @@ Mutex *osMutexCreate(Mutex &mutex) {
     return &mutex;
 }
 
-void osMutexWait(Mutex *mutex, unsigned int timeout) {
+osStatus osMutexWait(Mutex *mutex, uint32_t millisec) {
     while (mutex->locked) {
+        if (millisec != osWaitForever) {
+            if (millisec == 0) {
+                return osErrorTimeoutResource;
+            }
+            millisec--;
+        }
     	osDelay(1);
     }
-    mutex->locked = true;    
+    mutex->locked = true;
+    return osOK;
 }
 
 void osMutexRelease(Mutex *mutex) {
     mutex->locked = false;
 }
+
+#endif // OS_PTHREAD_SYNC
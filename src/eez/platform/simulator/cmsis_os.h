@@ -4,7 +4,9 @@
 
 typedef enum {
     osOK = 0,
-    osEventMessage = 0x10
+    osEventMessage = 0x10,
+    osEventTimeout = 0x40,
+    osErrorTimeoutResource = 0x81
 } osStatus;
 
 typedef enum {
@@ -55,12 +57,17 @@ typedef uint32_t osThreadId;
 typedef void *osThreadId;
 #else
 typedef pthread_t osThreadId;
+
+// message queues and mutexes are blocking on pthread mutex/condition variable,
+// on other platforms they are polling
+#define OS_PTHREAD_SYNC 1
 #endif
 
 #endif
 
 #define osThread(name) &os_thread_def_##name
 
+// Returns 0 if the thread is not created, i.e. in virtual time mode when all the thread slots are used.
 osThreadId osThreadCreate(const osThreadDef_t *thread_def, void *argument);
 
 osThreadId osThreadGetId();
@@ -73,6 +80,18 @@ uint32_t osKernelSysTick(void);
 
 extern uint32_t osKernelSysTickFrequency;
 
+// Virtual time: osKernelSysTick doesn't follow the wall clock, instead time jumps to the nearest
+// deadline as soon as all threads are waiting in osDelay, osMessageGet, osMessagePut or osMutexWait,
+// so long running sequences are executed much faster than real time and always see the same
+// timestamps. Must be enabled before the first thread is created. Returns false if not supported
+// on this platform.
+bool osVirtualTimeEnable();
+bool osVirtualTimeIsEnabled();
+uint64_t osVirtualTimeMicros();
+// Called by the thread that blocks outside of the primitives above (e.g. on console input),
+// otherwise virtual time would stop while it is blocked.
+void osVirtualTimeDetachThread();
+
 //
 
 #define osWaitForever     0xFFFFFFFF
@@ -92,6 +111,12 @@ struct MessageQueue {
     volatile uint16_t tail;
     volatile uint16_t head;
     volatile uint8_t overflow;
+#ifdef OS_PTHREAD_SYNC
+    uint16_t count;
+    pthread_mutex_t mutex;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+#endif
 };
 
 typedef MessageQueue *osMessageQId;
@@ -112,6 +137,9 @@ osStatus osMessagePut(osMessageQId queue_id, uint32_t info, uint32_t millisec);
 
 struct Mutex {
     bool locked;
+#ifdef OS_PTHREAD_SYNC
+    pthread_mutex_t mutex;
+#endif
 };
 
 #define osMutexDef(mutex) Mutex mutex
@@ -119,5 +147,5 @@ struct Mutex {
 #define osMutex(mutex) mutex
 
 Mutex *osMutexCreate(Mutex &mutex);
-void osMutexWait(Mutex *mutex, unsigned int timeout);
+osStatus osMutexWait(Mutex *mutex, uint32_t millisec);
 void osMutexRelease(Mutex *mutex);
\ No newline at end of file
@@ -18,9 +18,12 @@
 
 #include <eez/platform/simulator/events.h>
 
+#if !defined(EEZ_PLATFORM_SIMULATOR_HEADLESS)
 #include <SDL.h>
+#endif
 
 #include <eez/system.h>
+#include <eez/platform/simulator/headless.h>
 #include <eez/modules/mcu/encoder.h>
 
 namespace eez {
@@ -33,10 +36,8 @@ int g_mouseButton1DownX;
 int g_mouseButton1DownY;
 bool g_mouseButton1IsPressed;
 
-void readEvents() {
-    int yMouseWheel = 0;
-    bool mouseButton2IsUp = false;
-
+#if !defined(EEZ_PLATFORM_SIMULATOR_HEADLESS)
+static void pollEvents(int &yMouseWheel, bool &mouseButton2IsUp) {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
         if (event.type == SDL_MOUSEMOTION || event.type == SDL_MOUSEBUTTONDOWN || event.type == SDL_MOUSEBUTTONUP) {
@@ -63,6 +64,18 @@ void readEvents() {
             eez::shutdown();
         }
     }
+}
+#endif
+
+void readEvents() {
+    int yMouseWheel = 0;
+    bool mouseButton2IsUp = false;
+
+#if !defined(EEZ_PLATFORM_SIMULATOR_HEADLESS)
+    if (!g_headless) {
+        pollEvents(yMouseWheel, mouseButton2IsUp);
+    }
+#endif
 
     // for web simulator
     if (yMouseWheel >= 100 || yMouseWheel <= -100) {
@@ -0,0 +1,60 @@
+/*
+ * EEZ Middleware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <cmsis_os.h>
+
+#include <eez/debug.h>
+#include <eez/platform/simulator/headless.h>
+
+namespace eez {
+namespace platform {
+namespace simulator {
+
+#if defined(EEZ_PLATFORM_SIMULATOR_HEADLESS)
+bool g_headless = true;
+#else
+bool g_headless;
+#endif
+
+void parseCommandLine(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            g_headless = true;
+        } else if (strcmp(argv[i], "--virtual-time") == 0) {
+            if (!osVirtualTimeEnable()) {
+                fprintf(stderr, "--virtual-time is not supported on this platform\n");
+            }
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            const char *filePath = argv[++i];
+#ifdef DEBUG
+            if (!eez::debug::startTrace(filePath)) {
+                fprintf(stderr, "failed to create trace file %s\n", filePath);
+            }
+#else
+            fprintf(stderr, "--trace %s is ignored, it requires debug build\n", filePath);
+#endif
+        }
+    }
+}
+
+} // namespace simulator
+} // namespace platform
+} // namespace eez
@@ -0,0 +1,39 @@
+/*
+ * EEZ Middleware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace eez {
+namespace platform {
+namespace simulator {
+
+// Simulator is running without window, sound and mouse input, GUI is drawn
+// only when screenshot is requested. It is set with --headless command line
+// argument or always in EEZ_PLATFORM_SIMULATOR_HEADLESS build (without SDL).
+extern bool g_headless;
+
+// Command line arguments:
+//   --headless       see g_headless
+//   --virtual-time   time advances only when all tasks are blocked, see osVirtualTimeEnable
+//   --trace <file>   writes debug probe measurements to Chrome/Perfetto trace file, see
+//                    eez::debug::startTrace (only in debug build)
+void parseCommandLine(int argc, char **argv);
+
+} // namespace simulator
+} // namespace platform
+} // namespace eez
@@ -16,6 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#if !defined(EEZ_PLATFORM_SIMULATOR_HEADLESS)
+
 #include "texture.h"
 
 Texture::Texture() {
@@ -76,3 +78,5 @@ void Texture::render(SDL_Renderer *renderer, int x, int y, int w, int h) {
     // Render to screen
     SDL_RenderCopyEx(renderer, mTexture, &src_rect, &dst_rect, 0.0, NULL, SDL_FLIP_NONE);
 }
+
+#endif
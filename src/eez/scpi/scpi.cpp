@@ -139,6 +139,9 @@ void oneIter() {
 			else if (type == SCPI_QUEUE_MESSAGE_DLOG_FILE_WRITE) {
 				eez::psu::dlog_record::fileWrite();
 			}
+            else if (type == SCPI_QUEUE_MESSAGE_LIST_STREAM_REFILL) {
+                eez::psu::list::streamRefill(param);
+            }
             else if (type == SCPI_QUEUE_MESSAGE_DLOG_TOGGLE) {
                 eez::psu::dlog_record::toggle();
             } else if (type == SCPI_QUEUE_MESSAGE_DLOG_SHOW_FILE) {
@@ -232,6 +235,8 @@ void oneIter() {
 
 #if OPTION_SD_CARD
         sd_card::tick();
+
+        dlog_view::buildPyramidStep();
 #endif
 
 #ifdef DEBUG
@@ -243,6 +248,9 @@ void oneIter() {
 void resetContext(scpi_t *context) {
     scpi_psu_t *psuContext = (scpi_psu_t *)context->user_context;
     psuContext->selected_channel_index = 0;
+    // FORMat ASCii and FORMat:BORDer NORMal
+    psuContext->isBinaryDataFormat = false;
+    psuContext->isSwappedByteOrder = false;
 #if OPTION_SD_CARD
     psuContext->currentDirectory[0] = 0;
 #endif
@@ -64,6 +64,7 @@ extern osMessageQId g_scpiMessageQueueId;
 #define SCPI_QUEUE_MESSAGE_FILE_MANAGER_OPEN_IMAGE_FILE 12
 #define SCPI_QUEUE_MESSAGE_FILE_MANAGER_DELETE_FILE 13
 #define SCPI_QUEUE_MESSAGE_DLOG_UPLOAD_FILE 14
+#define SCPI_QUEUE_MESSAGE_LIST_STREAM_REFILL 15
 
 extern char g_listFilePath[CH_MAX][MAX_PATH_LENGTH];
 
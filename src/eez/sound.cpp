@@ -25,8 +25,11 @@
 #include <cmath>
 #include <queue>
 #include <stdio.h>
+#if !defined(EEZ_PLATFORM_SIMULATOR_HEADLESS)
 #include <SDL.h>
 #include <SDL_audio.h>
+#endif
+#include <eez/platform/simulator/headless.h>
 
 #elif defined(EEZ_PLATFORM_STM32)
 
@@ -1475,7 +1478,11 @@ static int g_playNextTuneIndex = -1;
 #if defined(EEZ_PLATFORM_SIMULATOR) && !defined(__EMSCRIPTEN__)
 static const uint32_t g_memoryForTuneSamplesSize = 256000;
 int16_t g_memoryForTuneSamples[g_memoryForTuneSamplesSize];
+#if defined(EEZ_PLATFORM_SIMULATOR_HEADLESS)
+uint32_t g_dev;
+#else
 SDL_AudioDeviceID g_dev;
+#endif
 #elif defined(EEZ_PLATFORM_STM32)
 static const uint32_t g_memoryForTuneSamplesSize = SOUND_TUNES_MEMORY_SIZE;
 uint8_t *g_memoryForTuneSamples = SOUND_TUNES_MEMORY;
@@ -1543,7 +1550,11 @@ void init() {
 	initTune(g_tunes[POWER_UP_TUNE]);
 #endif
 
-#if defined(EEZ_PLATFORM_SIMULATOR) && !defined(__EMSCRIPTEN__)
+#if defined(EEZ_PLATFORM_SIMULATOR) && !defined(__EMSCRIPTEN__) && !defined(EEZ_PLATFORM_SIMULATOR_HEADLESS)
+	if (platform::simulator::g_headless) {
+		return;
+	}
+
 	SDL_InitSubSystem(SDL_INIT_AUDIO);
 
 	SDL_AudioSpec desiredSpec;
@@ -1569,8 +1580,10 @@ void startPlay(int iTune) {
     Tune &tuneDef = g_tunes[iTune];
 	initTune(tuneDef);
 #if defined(EEZ_PLATFORM_SIMULATOR)
+#if !defined(EEZ_PLATFORM_SIMULATOR_HEADLESS)
     SDL_QueueAudio(g_dev, tuneDef.pSamples, tuneDef.numSamples * 2);
     SDL_PauseAudioDevice(g_dev, 0);
+#endif
 #elif defined(EEZ_PLATFORM_STM32)
 	HAL_DAC_Stop_DMA(&hdac, DAC_CHANNEL_1);
 	HAL_TIM_Base_Stop(&htim6);
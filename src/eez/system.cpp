@@ -120,6 +120,9 @@ void mainTask(const void *) {
 
 #if defined(EEZ_PLATFORM_SIMULATOR) && !defined(__EMSCRIPTEN__)
 void consoleInputTask(const void *) {
+    // getchar is blocking outside of the cmsis_os primitives
+    osVirtualTimeDetachThread();
+
     osMessagePut(g_scpiMessageQueueId, SCPI_QUEUE_SERIAL_MESSAGE(SERIAL_LINE_STATE_CHANGED, 1), osWaitForever);
 
     while (1) {
@@ -178,6 +181,9 @@ uint32_t micros() {
 #endif
 
 #if defined(EEZ_PLATFORM_SIMULATOR)
+    if (osVirtualTimeIsEnabled()) {
+        return (uint32_t)osVirtualTimeMicros();
+    }
 	return osKernelSysTick() * 1000;
 #endif
 }
@@ -40,7 +40,11 @@ const char *g_unitNames[] = {
     "Mohm",
     "%",
     "Hz",
-    "J"
+    "J",
+    "Ah",
+    "mAh",
+    "Wh",
+    "mWh"
 };
 
 static const int g_scpiUnits[] = {
@@ -61,7 +65,11 @@ static const int g_scpiUnits[] = {
     SCPI_UNIT_OHM,
     SCPI_UNIT_NONE,
     SCPI_UNIT_HERTZ,
-    SCPI_UNIT_JOULE
+    SCPI_UNIT_JOULE,
+    SCPI_UNIT_NONE,
+    SCPI_UNIT_NONE,
+    SCPI_UNIT_NONE,
+    SCPI_UNIT_NONE
 };
 
 int getScpiUnit(Unit unit) {
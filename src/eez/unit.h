@@ -38,7 +38,11 @@ enum Unit {
     UNIT_MOHM,
     UNIT_PERCENT,
     UNIT_FREQUENCY,
-    UNIT_JOULE
+    UNIT_JOULE,
+    UNIT_AMPER_HOUR,
+    UNIT_MILLI_AMPER_HOUR,
+    UNIT_WATT_HOUR,
+    UNIT_MILLI_WATT_HOUR
 };
 
 extern const char *g_unitNames[];
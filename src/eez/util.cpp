@@ -109,7 +109,219 @@ void strcatUInt32(char *str, uint32_t value) {
 }
 
 void strcatFloat(char *str, float value) {
-    sprintf(str + strlen(str), "%g", value);
+    formatFloat(str + strlen(str), value);
+}
+
+static const uint32_t POW10_INT[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+static const double POW10_DOUBLE[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+};
+
+// value * 10^exponent, divides for negative exponent because 10^-n is not exact in binary
+static double scaleByPow10(double value, int exponent) {
+    if (exponent >= 0) {
+        while (exponent > 15) {
+            value *= 1e15;
+            exponent -= 15;
+        }
+        return value * POW10_DOUBLE[exponent];
+    } else {
+        exponent = -exponent;
+        while (exponent > 15) {
+            value /= 1e15;
+            exponent -= 15;
+        }
+        return value / POW10_DOUBLE[exponent];
+    }
+}
+
+static char *writeUInt32(char *text, uint32_t value) {
+    char digits[10];
+    int n = 0;
+    do {
+        digits[n++] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+    while (n) {
+        *text++ = digits[--n];
+    }
+    return text;
+}
+
+// writes exactly numDigits digits, including the leading zeros
+static char *writeUInt32Digits(char *text, uint32_t value, int numDigits) {
+    for (int i = numDigits - 1; i >= 0; --i) {
+        text[i] = '0' + value % 10;
+        value /= 10;
+    }
+    return text + numDigits;
+}
+
+static char *writeUnit(char *text, const char *unit) {
+    if (unit) {
+        while (*unit) {
+            *text++ = *unit++;
+        }
+    }
+    *text = 0;
+    return text;
+}
+
+static char *writeNonFinite(char *text, float value, const char *unit) {
+    if (isNaN(value)) {
+        *text++ = 'n';
+        *text++ = 'a';
+        *text++ = 'n';
+    } else {
+        if (value < 0) {
+            *text++ = '-';
+        }
+        *text++ = 'i';
+        *text++ = 'n';
+        *text++ = 'f';
+    }
+    return writeUnit(text, unit);
+}
+
+char *formatFloat(char *text, float value, const char *unit) {
+    if (!isfinite(value)) {
+        return writeNonFinite(text, value, unit);
+    }
+
+    if (value == 0) {
+        *text++ = '0';
+        return writeUnit(text, unit);
+    }
+
+    double absValue = value;
+    if (absValue < 0) {
+        *text++ = '-';
+        absValue = -absValue;
+    }
+
+    // decimal exponent estimated from the binary one (log10(2) ~ 0.30103),
+    // then corrected so that mantissa has exactly 6 digits after rounding
+    int binaryExponent;
+    frexp(absValue, &binaryExponent);
+    int exponent = (int)floor((binaryExponent - 1) * 0.30103);
+
+    uint32_t mantissa;
+    while (true) {
+        double scaledValue = scaleByPow10(absValue, 5 - exponent);
+        mantissa = (uint32_t)scaledValue;
+        // round half to even, as printf does
+        double remainder = scaledValue - mantissa;
+        if (remainder > 0.5 || (remainder == 0.5 && (mantissa & 1))) {
+            mantissa++;
+        }
+        if (mantissa >= 1000000) {
+            exponent++;
+        } else if (mantissa < 100000) {
+            exponent--;
+        } else {
+            break;
+        }
+    }
+
+    char digits[6];
+    writeUInt32Digits(digits, mantissa, 6);
+
+    int numDigits = 6;
+    while (numDigits > 1 && digits[numDigits - 1] == '0') {
+        numDigits--;
+    }
+
+    if (exponent < -4 || exponent >= 6) {
+        // same as %e, but without trailing zeros
+        *text++ = digits[0];
+        if (numDigits > 1) {
+            *text++ = '.';
+            for (int i = 1; i < numDigits; i++) {
+                *text++ = digits[i];
+            }
+        }
+        *text++ = 'e';
+        if (exponent < 0) {
+            *text++ = '-';
+            exponent = -exponent;
+        } else {
+            *text++ = '+';
+        }
+        if (exponent < 10) {
+            *text++ = '0';
+        }
+        text = writeUInt32(text, exponent);
+    } else if (exponent >= 0) {
+        int i;
+        for (i = 0; i <= exponent; i++) {
+            *text++ = digits[i];
+        }
+        if (numDigits > i) {
+            *text++ = '.';
+            for (; i < numDigits; i++) {
+                *text++ = digits[i];
+            }
+        }
+    } else {
+        *text++ = '0';
+        *text++ = '.';
+        for (int i = -1; i > exponent; i--) {
+            *text++ = '0';
+        }
+        for (int i = 0; i < numDigits; i++) {
+            *text++ = digits[i];
+        }
+    }
+
+    return writeUnit(text, unit);
+}
+
+char *formatFloatPrec(char *text, float value, float precision, const char *unit) {
+    if (!isfinite(value) || !(precision > 0) || fabs(value) >= 1E9f) {
+        return formatFloat(text, value, unit);
+    }
+
+    // 0.005 -> 3 decimals, 0.0005 -> 4 decimals, 1 -> 0 decimals
+    int numDecimals = 0;
+    while (precision < 0.999f && numDecimals < 9) {
+        precision *= 10;
+        numDecimals++;
+    }
+
+    double absValue = value;
+    bool negative = absValue < 0;
+    if (negative) {
+        absValue = -absValue;
+    }
+
+    uint64_t scaledValue = (uint64_t)(absValue * POW10_DOUBLE[numDecimals] + 0.5);
+    if (scaledValue == 0) {
+        *text++ = '0';
+        return writeUnit(text, unit);
+    }
+
+    if (negative) {
+        *text++ = '-';
+    }
+
+    uint32_t integerPart = (uint32_t)(scaledValue / POW10_INT[numDecimals]);
+    uint32_t fractionalPart = (uint32_t)(scaledValue % POW10_INT[numDecimals]);
+
+    text = writeUInt32(text, integerPart);
+
+    if (fractionalPart) {
+        while (fractionalPart % 10 == 0) {
+            fractionalPart /= 10;
+            numDecimals--;
+        }
+        *text++ = '.';
+        text = writeUInt32Digits(text, fractionalPart, numDecimals);
+    }
+
+    return writeUnit(text, unit);
 }
 
 #if defined(EEZ_PLATFORM_STM32)
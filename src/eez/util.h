@@ -59,6 +59,13 @@ void strcatInt32(char *str, int32_t value);
 void strcatUInt32(char *str, uint32_t value);
 void strcatFloat(char *str, float value);
 
+// Writes value the same way as sprintf("%g") does, followed by the unit (if not null), without
+// going through printf. Returns pointer to the terminating zero, so more text can be appended.
+char *formatFloat(char *text, float value, const char *unit = nullptr);
+// Writes value rounded to the precision (e.g. Channel::getValuePrecision), number of decimals
+// follows from the precision and trailing zeros are removed.
+char *formatFloatPrec(char *text, float value, float precision, const char *unit = nullptr);
+
 uint32_t crc32(const uint8_t *message, size_t size);
 
 uint8_t toBCD(uint8_t bin);
@@ -142,6 +142,8 @@ extern "C" {
     typedef size_t(*scpi_write_t)(scpi_t * context, const char * data, size_t len);
     typedef scpi_result_t(*scpi_write_control_t)(scpi_t * context, scpi_ctrl_name_t ctrl, scpi_reg_val_t val);
     typedef int (*scpi_error_callback_t)(scpi_t * context, int_fast16_t error);
+    typedef const scpi_command_t * (*scpi_find_command_t)(scpi_t * context, const char * header, size_t len);
+    typedef scpi_result_t(*scpi_execute_command_t)(scpi_t * context, const scpi_command_t * cmd);
 
     /* scpi lexer */
     enum _scpi_token_type_t {
@@ -382,6 +384,10 @@ extern "C" {
         scpi_parser_state_t parser_state;
         const char * idn[4];
         size_t arbitrary_reminding;
+        /* optional replacement for the linear search of cmdlist */
+        scpi_find_command_t find_command;
+        /* optional wrapper around the command callback, e.g. for profiling */
+        scpi_execute_command_t execute_command;
     };
 
     enum _scpi_array_format_t {
@@ -127,6 +127,7 @@ static scpi_bool_t processCommand(scpi_t * context) {
     const scpi_command_t * cmd = context->param_list.cmd;
     lex_state_t * state = &context->param_list.lex_state;
     scpi_bool_t result = TRUE;
+    scpi_result_t callback_result;
 
     /* conditionaly write ; */
     writeSemicolon(context);
@@ -138,7 +139,12 @@ static scpi_bool_t processCommand(scpi_t * context) {
 
     /* if callback exists - call command callback */
     if (cmd->callback != NULL) {
-        if ((cmd->callback(context) != SCPI_RES_OK)) {
+        if (context->execute_command) {
+            callback_result = context->execute_command(context, cmd);
+        } else {
+            callback_result = cmd->callback(context);
+        }
+        if (callback_result != SCPI_RES_OK) {
             if (!context->cmd_error) {
                 SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
             }
@@ -168,6 +174,15 @@ static scpi_bool_t findCommandHeader(scpi_t * context, const char * header, int
     int32_t i;
     const scpi_command_t * cmd;
 
+    if (context->find_command) {
+        cmd = context->find_command(context, header, len);
+        if (cmd) {
+            context->param_list.cmd = cmd;
+            return TRUE;
+        }
+        return FALSE;
+    }
+
     for (i = 0; context->cmdlist[i].pattern != NULL; i++) {
         cmd = &context->cmdlist[i];
         if (matchCommand(cmd->pattern, header, len, NULL, 0, 0)) {
@@ -220,6 +220,7 @@ QDEF(MP_QSTR_fmod, (const byte*)"\xe5\x04" "fmod")
 QDEF(MP_QSTR_frexp, (const byte*)"\x1c\x05" "frexp")
 QDEF(MP_QSTR_function, (const byte*)"\x27\x08" "function")
 QDEF(MP_QSTR_generator, (const byte*)"\x96\x09" "generator")
+QDEF(MP_QSTR_getAll, (const byte*)"\x52\x06" "getAll")
 QDEF(MP_QSTR_getI, (const byte*)"\xda\x04" "getI")
 QDEF(MP_QSTR_getOutputMode, (const byte*)"\x4f\x0d" "getOutputMode")
 QDEF(MP_QSTR_getU, (const byte*)"\xc6\x04" "getU")
@@ -247,6 +248,7 @@ QDEF(MP_QSTR_pi, (const byte*)"\x1c\x02" "pi")
 QDEF(MP_QSTR_radians, (const byte*)"\x87\x07" "radians")
 QDEF(MP_QSTR_real, (const byte*)"\xbf\x04" "real")
 QDEF(MP_QSTR_scpi, (const byte*)"\xec\x04" "scpi")
+QDEF(MP_QSTR_setAll, (const byte*)"\xc6\x06" "setAll")
 QDEF(MP_QSTR_setI, (const byte*)"\x4e\x04" "setI")
 QDEF(MP_QSTR_setU, (const byte*)"\x52\x04" "setU")
 QDEF(MP_QSTR_sin, (const byte*)"\xb1\x03" "sin")
@@ -156,12 +156,101 @@ mp_obj_t modeez_getOutputMode(mp_obj_t channelIndexObj) {
     return mp_obj_new_str(modeStr, strlen(modeStr));
 }
 
+mp_obj_t modeez_getAll() {
+    mp_obj_t channelItems[CH_NUM];
+
+    for (int channelIndex = 0; channelIndex < CH_NUM; channelIndex++) {
+        Channel &channel = Channel::get(channelIndex);
+
+        const char *modeStr = channel.getModeStr();
+
+        mp_obj_t items[6] = {
+            mp_obj_new_float(channel_dispatcher::getUMonLast(channel)),
+            mp_obj_new_float(channel_dispatcher::getIMonLast(channel)),
+            mp_obj_new_float(channel_dispatcher::getUSet(channel)),
+            mp_obj_new_float(channel_dispatcher::getISet(channel)),
+            mp_obj_new_bool(channel.isOutputEnabled()),
+            mp_obj_new_str(modeStr, strlen(modeStr))
+        };
+
+        channelItems[channelIndex] = mp_obj_new_tuple(6, items);
+    }
+
+    return mp_obj_new_tuple(CH_NUM, channelItems);
+}
+
+mp_obj_t modeez_setAll(mp_obj_t settingsObj) {
+    size_t numSettings;
+    mp_obj_t *settings;
+    mp_obj_get_array(settingsObj, &numSettings, &settings);
+
+    if (numSettings > (size_t)CH_NUM) {
+        mp_raise_ValueError("Too many values");
+    }
+
+    Channel *channels[CH_NUM];
+    float voltages[CH_NUM];
+    float currents[CH_NUM];
+
+    // validate everything first, so that either all channels are changed or none
+    for (size_t i = 0; i < numSettings; i++) {
+        mp_obj_t *setting;
+        mp_obj_get_array_fixed_n(settings[i], 3, &setting);
+
+        int channelIndex = mp_obj_get_int(setting[0]) - 1;
+        if (channelIndex < 0 || channelIndex >= CH_NUM) {
+            mp_raise_ValueError("Invalid channel index");
+        }
+        Channel &channel = Channel::get(channelIndex);
+
+        for (size_t j = 0; j < i; j++) {
+            if (channels[j] == &channel) {
+                mp_raise_ValueError("Duplicate channel index");
+            }
+        }
+
+        if ((channel_dispatcher::getVoltageTriggerMode(channel) != TRIGGER_MODE_FIXED || channel_dispatcher::getCurrentTriggerMode(channel) != TRIGGER_MODE_FIXED) && !trigger::isIdle()) {
+            mp_raise_ValueError("Can not change transient trigger");
+        }
+
+        if (channel.isRemoteProgrammingEnabled()) {
+            mp_raise_ValueError("Remote programming enabled");
+        }
+
+        float voltage = mp_obj_get_float(setting[1]);
+        float current = mp_obj_get_float(setting[2]);
+
+        if (voltage > channel_dispatcher::getULimit(channel)) {
+            mp_raise_ValueError("Voltage limit exceeded");
+        }
+
+        if (current > channel_dispatcher::getILimit(channel)) {
+            mp_raise_ValueError("Current limit exceeded");
+        }
+
+        if (voltage * current > channel_dispatcher::getPowerLimit(channel)) {
+            mp_raise_ValueError("Power limit exceeded");
+        }
+
+        channels[i] = &channel;
+        voltages[i] = voltage;
+        currents[i] = current;
+    }
+
+    for (size_t i = 0; i < numSettings; i++) {
+        channel_dispatcher::setVoltage(*channels[i], voltages[i]);
+        channel_dispatcher::setCurrent(*channels[i], currents[i]);
+    }
+
+    return mp_const_none;
+}
+
 mp_obj_t modeez_dlogTraceData(size_t n_args, const mp_obj_t *args) {
     if (!dlog_record::isTraceExecuting()) {
         mp_raise_ValueError("DLOG trace data not started");
     }
 
-    if (n_args == 1 && mp_obj_is_type(args[0], &mp_type_list)) {
+    if (n_args == 1 && (mp_obj_is_type(args[0], &mp_type_list) || mp_obj_is_type(args[0], &mp_type_tuple))) {
         mp_obj_get_array(args[0], &n_args, (mp_obj_t **)&args);
     }
 
@@ -176,7 +265,7 @@ mp_obj_t modeez_dlogTraceData(size_t n_args, const mp_obj_t *args) {
     float values[dlog_view::MAX_NUM_OF_Y_AXES];
 
     for (size_t i = 0; i < MIN(n_args, dlog_view::MAX_NUM_OF_Y_AXES); i++) {
-        if (!mp_obj_is_type(args[i], &mp_type_float)) {
+        if (!mp_obj_is_float(args[i]) && !mp_obj_is_int(args[i])) {
             mp_raise_ValueError("Argument is not float");
         }
         values[i] = mp_obj_get_float(args[i]);
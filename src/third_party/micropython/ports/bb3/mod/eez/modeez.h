@@ -26,4 +26,6 @@ mp_obj_t modeez_setU(mp_obj_t channelIndexObj, mp_obj_t value);
 mp_obj_t modeez_getI(mp_obj_t channelIndexObj);
 mp_obj_t modeez_setI(mp_obj_t channelIndexObj, mp_obj_t value);
 mp_obj_t modeez_getOutputMode(mp_obj_t channelIndexObj);
+mp_obj_t modeez_getAll();
+mp_obj_t modeez_setAll(mp_obj_t settingsObj);
 mp_obj_t modeez_dlogTraceData(size_t n_args, const mp_obj_t *args);
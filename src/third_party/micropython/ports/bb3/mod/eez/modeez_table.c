@@ -24,6 +24,8 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_2(modeez_setU_obj, modeez_setU);
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(modeez_getI_obj, modeez_getI);
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(modeez_setI_obj, modeez_setI);
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(modeez_getOutputMode_obj, modeez_getOutputMode);
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(modeez_getAll_obj, modeez_getAll);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(modeez_setAll_obj, modeez_setAll);
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(modeez_dlogTraceData_obj, 1, 4, modeez_dlogTraceData);
 
 STATIC const mp_rom_map_elem_t modeez_module_globals_table[] = {
@@ -34,6 +36,8 @@ STATIC const mp_rom_map_elem_t modeez_module_globals_table[] = {
   { MP_ROM_QSTR(MP_QSTR_getI), (mp_obj_t)&modeez_getI_obj },
   { MP_ROM_QSTR(MP_QSTR_setI), (mp_obj_t)&modeez_setI_obj },
   { MP_ROM_QSTR(MP_QSTR_getOutputMode), (mp_obj_t)&modeez_getOutputMode_obj },
+  { MP_ROM_QSTR(MP_QSTR_getAll), (mp_obj_t)&modeez_getAll_obj },
+  { MP_ROM_QSTR(MP_QSTR_setAll), (mp_obj_t)&modeez_setAll_obj },
   { MP_ROM_QSTR(MP_QSTR_dlogTraceData), (mp_obj_t)&modeez_dlogTraceData_obj },
 };
 
@@ -125,6 +125,9 @@ void sntpSetSystemTimeUs(uint32_t t, uint32_t us);
 /*-----------------------------------------------------------------------------*/
 /* USER CODE BEGIN 1 */
 
+/* room for a whole JSON telemetry frame of all channels, see eez/mqtt.cpp */
+#define MQTT_OUTPUT_RINGBUF_SIZE 1024
+
 /* USER CODE END 1 */
 
 #ifdef __cplusplus